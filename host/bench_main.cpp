@@ -0,0 +1,26 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Host run of the hot-path microbenchmarks (src/bench.cpp).
+
+#include "host_hal.h"
+#include "gps_task.h"
+#include "timebase.h"
+#include "bench.h"
+
+int main() {
+    timebase_init();
+    gps_task_init();
+    bench_run_all();
+    return 0;
+}
@@ -0,0 +1,543 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Deterministic clock simulator for the timing core (host build).
+//
+// Models the Pico's crystal as a 1 MHz counter whose fractional frequency
+// error is offset + tempco * (T - 25 C) + tempco2 * (T - 25 C)^2 + a random
+// walk, with T swinging sinusoidally; the die temperature sensor reads T
+// plus a little noise. Each true UTC second gets a PPS edge (plus Gaussian jitter)
+// and an RMC/GGA pair that arrives after a random processing latency plus
+// 9600-baud serial time. Everything goes through the firmware's own
+// gps_task_poll()/PPS IRQ path via host_hal.h; the simulator only compares
+// timebase_local_to_unix() against true time.
+//
+// Usage: clocksim [--scenario NAME] [--seed N] [--csv FILE] [--adev FILE] [overrides...]
+// Same scenario + seed => identical output.
+
+#include "host_hal.h"
+#include "gps_task.h"
+#include "timebase.h"
+#include "pps_out.h"
+#include "pps_stats.h"
+#include "stability.h"
+#include "servo.h"
+#include "hardware/gpio.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr double   PI            = 3.14159265358979323846;
+constexpr uint32_t PPS_GPIO      = 16;       // as wired in gps_task_init()
+constexpr uint64_t UTC_START     = 1790000000ULL;   // 2026-09-21T14:13:20Z
+constexpr double   BOOT_LOCAL_NS = 5e9;      // counter value at sim start
+constexpr double   BAUD_CHAR_S   = 10.0 / 9600.0;
+constexpr double   TEMP_NOISE_C  = 0.5;      // die sensor noise (1 sigma)
+
+struct Scenario {
+    const char* name;
+    const char* about;
+    uint32_t duration_s;      // total simulated seconds
+    uint32_t holdover_at_s;   // GPS + PPS lost from here on (0 = never)
+    uint32_t holdover_len_s;  // ... and back after this long (0 = never)
+    double   offset_ppm;      // static crystal error (+ = counter fast)
+    double   tempco_ppb_c;    // linear tempco around 25 C
+    double   tempco2_ppb_c2;  // quadratic tempco around 25 C
+    double   temp_amp_c;      // sinusoidal temperature swing (peak)
+    double   temp_period_s;
+    double   rw_ppb;          // frequency random walk per sqrt(second)
+    double   jitter_ns;       // PPS edge jitter (1 sigma)
+    double   lat_ms;          // NMEA processing latency after the edge (min)
+    double   lat_spread_ms;   // ... plus uniform [0, spread)
+    double   conv_ns;         // |err| bound for "converged"
+    double   rmc_loss_pct;    // RMC sentences dropped (GGA and PPS still arrive)
+    double   pps_miss_pct;    // PPS pulses dropped
+    double   pps_extra_pct;   // seconds with a spurious extra pulse
+};
+
+const Scenario k_scenarios[] = {
+    { "nominal",  "room temperature, clean PPS",
+      900,       0,    0,  12.5,    0.0,  0.0, 0.0,    1.0, 0.02,    50.0, 120.0,  80.0, 1000.0, 0.0, 0.0, 0.0 },
+    { "thermal",  "+-4 C swing over 20 min, 0.2 ppm/C",
+      3600,      0,    0, -18.0,  200.0,  0.0, 4.0, 1200.0, 0.02,    50.0, 120.0,  80.0, 1000.0, 0.0, 0.0, 0.0 },
+    { "jittery",  "2 us PPS jitter, slow and noisy NMEA (5% of RMCs lost)",
+      1800,      0,    0,  12.5,    0.0,  0.0, 0.0,    1.0, 0.05,  2000.0, 250.0, 300.0, 5000.0, 5.0, 0.0, 0.0 },
+    { "holdover", "15 min locked, then 15 min without GPS/PPS, slow drift",
+      1800,    900,    0,  12.5,  200.0,  0.0, 1.0, 3600.0, 0.05,    50.0, 120.0,  80.0, 1000.0, 0.0, 0.0, 0.0 },
+    { "tempco",   "4 h of +-8 C swings to learn the curve, then 45 min holdover while warming",
+      18000, 14400, 2700,  12.5,  150.0, -6.0, 8.0, 7200.0, 0.02,    50.0, 120.0,  80.0, 1000.0, 0.0, 0.0, 0.0 },
+    { "glitchy",  "clean crystal, 2% of PPS pulses missing, 2% doubled by glitches",
+      900,       0,    0,  12.5,    0.0,  0.0, 0.0,    1.0, 0.02,    50.0, 120.0,  80.0, 1000.0, 0.0, 2.0, 2.0 },
+};
+
+struct Sample {
+    uint32_t t_s;
+    double   err_ns;          // timebase - true time
+    double   true_ppb;        // counter frequency error
+    TimebaseStatus tb;
+};
+
+// Local counter model. Rate is held constant across each true second.
+struct Crystal {
+    const Scenario* sc;
+    std::mt19937_64 rng;
+    double rw_ppb   = 0.0;
+    double rate_ppb = 0.0;    // this second's fractional error
+    double base_ns  = BOOT_LOCAL_NS;   // counter (ns) at the start of this second
+
+    double temp_c(double t) const {
+        return 25.0 + sc->temp_amp_c * std::sin(2.0 * PI * t / sc->temp_period_s);
+    }
+
+    void begin_second(uint32_t n) {
+        std::normal_distribution<double> step(0.0, sc->rw_ppb);
+        if (n) rw_ppb += step(rng);
+        const double dT = temp_c(n + 0.5) - 25.0;
+        rate_ppb = sc->offset_ppm * 1000.0 + sc->tempco_ppb_c * dT + sc->tempco2_ppb_c2 * dT * dT + rw_ppb;
+    }
+
+    // Counter (ns) at offset `dt` seconds into the current second.
+    double local_ns(double dt) const { return base_ns + dt * 1e9 * (1.0 + rate_ppb * 1e-9); }
+
+    void end_second() { base_ns = local_ns(1.0); }
+};
+
+enum class Ev : uint8_t { Pps, Nmea, Service, Sample };
+
+// Disciplined outputs (pps_out.h) as seen on the pins: each rising edge
+// against true time (the nearest whole second, or the nearest point of the
+// square wave's 1/f grid).
+struct OutEdge {
+    uint32_t t_s;
+    double   err_ns;
+};
+
+struct OutputLog {
+    const Crystal* xo = nullptr;
+    uint32_t n = 0;                 // second the crystal model is in
+    std::vector<OutEdge> pps;
+    std::vector<OutEdge> freq;
+};
+
+OutputLog g_out;
+
+void on_gpio_output(uint32_t gpio, bool level, uint64_t at_ns) {
+    if (!level || !g_out.xo) return;
+    const Crystal& xo = *g_out.xo;
+    const double dt = (static_cast<double>(at_ns) - xo.base_ns) / (1e9 * (1.0 + xo.rate_ppb * 1e-9));
+
+    if (gpio == PPS_OUT_GPIO) {
+        g_out.pps.push_back({ g_out.n, (dt - std::round(dt)) * 1e9 });
+    } else if (PPS_OUT_FREQ_HZ > 0 && gpio == PPS_OUT_FREQ_GPIO) {
+        const double f = PPS_OUT_FREQ_HZ;
+        g_out.freq.push_back({ g_out.n, (dt - std::round(dt * f) / f) * 1e9 });
+    }
+}
+
+// Fire the alarms due up to local counter value local_ns (strictly before
+// it unless inclusive), each at its own target time.
+void run_alarms_until(double local_ns, bool inclusive) {
+    uint64_t at = 0;
+    while (host_alarm_next_us(&at)) {
+        const double at_ns = static_cast<double>(at) * 1000.0;
+        if (at_ns > local_ns || (!inclusive && at_ns == local_ns)) break;
+        if (at > host_time_us()) host_time_set_us(at);
+        host_alarm_run_due();
+    }
+}
+
+struct Event {
+    double  dt;           // seconds into the current true second
+    Ev      kind;
+    uint8_t sentence;     // Nmea: 0 = RMC, 1 = GGA
+};
+
+void civil_from_days(int64_t z, int* y, unsigned* m, unsigned* d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp  = (5 * doy + 2) / 153;
+    *d = doy - (153 * mp + 2) / 5 + 1;
+    *m = mp < 10 ? mp + 3 : mp - 9;
+    *y = static_cast<int>(yoe) + static_cast<int>(era) * 400 + (*m <= 2);
+}
+
+size_t make_sentence(char* out, size_t cap, uint8_t which, uint64_t unix_s) {
+    const uint64_t sod = unix_s % 86400;
+    int y; unsigned m, d;
+    civil_from_days(static_cast<int64_t>(unix_s / 86400), &y, &m, &d);
+
+    char body[96];
+    if (which == 0) {
+        std::snprintf(body, sizeof(body),
+                      "GPRMC,%02u%02u%02u.00,A,4807.038,N,01131.000,E,0.0,0.0,%02u%02u%02d,,,A",
+                      (unsigned)(sod / 3600), (unsigned)(sod / 60 % 60), (unsigned)(sod % 60),
+                      d, m, y % 100);
+    } else {
+        std::snprintf(body, sizeof(body),
+                      "GPGGA,%02u%02u%02u.00,4807.038,N,01131.000,E,1,09,0.9,545.4,M,46.9,M,,",
+                      (unsigned)(sod / 3600), (unsigned)(sod / 60 % 60), (unsigned)(sod % 60));
+    }
+    uint8_t ck = 0;
+    for (const char* p = body; *p; ++p) ck ^= static_cast<uint8_t>(*p);
+    const int n = std::snprintf(out, cap, "$%s*%02X\r\n", body, ck);
+    return n > 0 ? static_cast<size_t>(n) : 0;
+}
+
+// timebase - truth, at true time (utc_s + dt) == counter value local_ns.
+bool measure_err_ns(double local_ns, uint64_t utc_s, double dt, double* err_ns) {
+    uint64_t s = 0;
+    uint32_t ns = 0;
+    if (!timebase_local_to_unix(static_cast<uint64_t>(local_ns / 1000.0), &s, &ns)) return false;
+    *err_ns = (static_cast<double>(static_cast<int64_t>(s - utc_s)) - dt) * 1e9 + ns;
+    return true;
+}
+
+bool parse_args(int argc, char** argv, Scenario* sc, uint64_t* seed, const char** csv, const char** adev) {
+    const char* name = "nominal";
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--scenario")) name = argv[i + 1];
+    }
+    const Scenario* base = nullptr;
+    for (const Scenario& s : k_scenarios) {
+        if (!std::strcmp(s.name, name)) base = &s;
+    }
+    if (!base) {
+        std::fprintf(stderr, "unknown scenario '%s'; one of:\n", name);
+        for (const Scenario& s : k_scenarios) std::fprintf(stderr, "  %-9s %s\n", s.name, s.about);
+        return false;
+    }
+    *sc = *base;
+
+    struct Opt { const char* flag; double* d; uint32_t* u; };
+    const Opt opts[] = {
+        { "--duration",      nullptr,           &sc->duration_s },
+        { "--holdover-at",   nullptr,           &sc->holdover_at_s },
+        { "--holdover-len",  nullptr,           &sc->holdover_len_s },
+        { "--ppm",           &sc->offset_ppm,    nullptr },
+        { "--tempco",        &sc->tempco_ppb_c,  nullptr },
+        { "--tempco2",       &sc->tempco2_ppb_c2, nullptr },
+        { "--temp-amp",      &sc->temp_amp_c,    nullptr },
+        { "--temp-period",   &sc->temp_period_s, nullptr },
+        { "--rw",            &sc->rw_ppb,        nullptr },
+        { "--jitter-ns",     &sc->jitter_ns,     nullptr },
+        { "--lat-ms",        &sc->lat_ms,        nullptr },
+        { "--lat-spread-ms", &sc->lat_spread_ms, nullptr },
+        { "--conv-ns",       &sc->conv_ns,       nullptr },
+        { "--rmc-loss",      &sc->rmc_loss_pct,  nullptr },
+        { "--pps-miss",      &sc->pps_miss_pct,  nullptr },
+        { "--pps-extra",     &sc->pps_extra_pct, nullptr },
+    };
+
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "missing value for %s\n", argv[i]);
+            return false;
+        }
+        const char* flag = argv[i];
+        const char* val  = argv[i + 1];
+        if (!std::strcmp(flag, "--scenario")) continue;
+        if (!std::strcmp(flag, "--seed")) { *seed = std::strtoull(val, nullptr, 0); continue; }
+        if (!std::strcmp(flag, "--csv"))  { *csv = val; continue; }
+        if (!std::strcmp(flag, "--adev")) { *adev = val; continue; }
+
+        bool known = false;
+        for (const Opt& o : opts) {
+            if (std::strcmp(flag, o.flag)) continue;
+            if (o.d) *o.d = std::strtod(val, nullptr);
+            else     *o.u = static_cast<uint32_t>(std::strtoul(val, nullptr, 0));
+            known = true;
+        }
+        if (!known) {
+            std::fprintf(stderr, "unknown option %s\n", flag);
+            return false;
+        }
+    }
+    if (sc->temp_period_s <= 0.0) sc->temp_period_s = 1.0;
+    return true;
+}
+
+void report(const Scenario& sc, uint64_t seed, const std::vector<Sample>& v) {
+    const uint32_t gps_end = sc.holdover_at_s ? sc.holdover_at_s : sc.duration_s;
+    // Convergence: first second from which |err| stays inside conv_ns until GPS loss.
+    int64_t converged = -1;
+    for (const Sample& s : v) {
+        if (s.t_s >= gps_end) break;
+        const bool in = s.tb.synced && std::fabs(s.err_ns) <= sc.conv_ns;
+        if (!in) converged = -1;
+        else if (converged < 0) converged = s.t_s;
+    }
+
+    // Steady state: second half of the GPS-on window.
+    double sum = 0, sum2 = 0, worst = 0;
+    uint32_t n = 0;
+    for (const Sample& s : v) {
+        if (s.t_s < gps_end / 2 || s.t_s >= gps_end) continue;
+        sum += s.err_ns;
+        sum2 += s.err_ns * s.err_ns;
+        if (std::fabs(s.err_ns) > worst) worst = std::fabs(s.err_ns);
+        n++;
+    }
+
+    std::printf("scenario   %s (seed %llu): %s\r\n", sc.name, (unsigned long long)seed, sc.about);
+    if (converged >= 0) std::printf("converged  %lld s (|err| <= %.0f ns, synced)\r\n", (long long)converged, sc.conv_ns);
+    else                std::printf("converged  never\r\n");
+    if (n) {
+        const double mean = sum / n;
+        std::printf("steady     mean %.0f ns  rms %.0f ns  max %.0f ns  (%u samples)\r\n",
+                    mean, std::sqrt(sum2 / n), worst, n);
+    }
+    if (gps_end > 0 && gps_end <= v.size()) {
+        // What a client is told while locked, and whether it holds.
+        uint32_t over = 0;
+        for (const Sample& s : v) {
+            if (s.t_s < gps_end / 2 || s.t_s >= gps_end) continue;
+            if (std::fabs(s.err_ns) > s.tb.error_ns) over++;
+        }
+        const TimebaseStatus& tb = v[gps_end - 1].tb;
+        std::printf("quality    stratum %u  precision 2^%d s  jitter %lu ns  dispersion %lu ns  (exceeded in %u of %u s)\r\n",
+                    (unsigned)tb.stratum, (int)tb.precision, (unsigned long)tb.jitter_ns,
+                    (unsigned long)tb.error_ns, over, n);
+    }
+    if (sc.holdover_at_s && sc.holdover_at_s < v.size()) {
+        const uint32_t hold_end = std::min<uint32_t>(
+            sc.holdover_len_s ? sc.holdover_at_s + sc.holdover_len_s : sc.duration_s,
+            static_cast<uint32_t>(v.size()));
+        for (uint32_t after : { 60u, 300u, 900u, 3600u }) {
+            const uint32_t t = sc.holdover_at_s + after;
+            if (t >= hold_end) break;
+            std::printf("holdover   +%4u s  err %.0f ns  (bound %lu ns, stratum %u)\r\n", after,
+                        v[t].err_ns, (unsigned long)v[t].tb.error_ns, (unsigned)v[t].tb.stratum);
+        }
+        const Sample& end = v[hold_end - 1];
+        std::printf("holdover   end (+%u s)  err %.0f ns  (bound %lu ns, stratum %u)\r\n",
+                    end.t_s - sc.holdover_at_s, end.err_ns,
+                    (unsigned long)end.tb.error_ns, (unsigned)end.tb.stratum);
+        std::printf("holdover   tempco correction %d ppb now, %lld ns integrated\r\n",
+                    end.tb.tempco.hold_adj_ppb, (long long)end.tb.tempco.hold_adj_ns);
+
+        // The advertised bound must cover the real error throughout.
+        uint32_t violations = 0;
+        for (uint32_t t = sc.holdover_at_s; t < hold_end; ++t) {
+            if (std::fabs(v[t].err_ns) > v[t].tb.error_ns) violations++;
+        }
+        std::printf("holdover   bound exceeded in %u of %u s\r\n",
+                    violations, hold_end - sc.holdover_at_s);
+    }
+
+    const TimebaseTempco& tc = v.back().tb.tempco;
+    if (tc.order) {
+        std::printf("tempco     %s fit over %u bins (%u samples), resid %d ppb rms\r\n",
+                    tc.order == 2 ? "quadratic" : "linear", (unsigned)tc.bins,
+                    (unsigned)tc.samples, tc.resid_ppb);
+    }
+    if (tc.have_recovery) {
+        std::printf("recovery   after %u s: error %lld ns, without tempco %lld ns\r\n",
+                    tc.recovery_after_s, (long long)tc.recovery_err_ns,
+                    (long long)tc.recovery_uncomp_ns);
+    }
+    PpsStats ps{};
+    if (pps_stats_get(&ps) && ps.edges) {
+        std::printf("pps        %u edges: %u accepted, %u outlier, %u extra, %u missing; "
+                    "interval %+d ns std %u ns (%u s), tol %u ns\r\n",
+                    ps.edges, ps.accepted, ps.outliers, ps.extra, ps.missing,
+                    ps.long_win.mean_ns, ps.long_win.std_ns, ps.long_win.n, ps.tol_ns);
+    }
+    StabilityReport st{};
+    if (stability_get(&st) && st.samples) {
+        std::printf("stability  %u samples, %u gaps:", st.samples, st.gaps);
+        for (const StabilityPoint& p : st.pt) {
+            if (p.n_mdev && (p.tau_s == 1 || p.tau_s == 16 || p.tau_s == 256)) {
+                std::printf("  tau %u s ADEV %.2e MDEV %.2e TDEV %.1f ns", p.tau_s, p.adev, p.mdev, p.tdev_ns);
+            }
+        }
+        std::printf("\r\n");
+    }
+    // Generated outputs over the steady-state window, against true time and
+    // as the firmware logged it against the GPS edges.
+    struct Acc {
+        uint32_t n = 0;
+        double sum = 0, sum2 = 0, worst = 0;
+        void add(double e) { n++; sum += e; sum2 += e * e; worst = std::max(worst, std::fabs(e)); }
+    };
+    Acc pps_acc, freq_acc;
+    for (const OutEdge& e : g_out.pps)  if (e.t_s >= gps_end / 2 && e.t_s < gps_end) pps_acc.add(e.err_ns);
+    for (const OutEdge& e : g_out.freq) if (e.t_s >= gps_end / 2 && e.t_s < gps_end) freq_acc.add(e.err_ns);
+    PpsOutStats po{};
+    if (pps_out_get(&po) && po.pulses) {
+        std::printf("ppsout     %u pulses (%u late, %u skipped)", po.pulses, po.late, po.skipped);
+        if (pps_acc.n) {
+            std::printf(", steady vs true: mean %.0f ns  rms %.0f ns  max %.0f ns",
+                        pps_acc.sum / pps_acc.n, std::sqrt(pps_acc.sum2 / pps_acc.n), pps_acc.worst);
+        }
+        std::printf("\r\n");
+        std::printf("ppsout     logged vs GPS edge: last %+d ns, mean %+d rms %u max %u ns over %u; %u matched, %u unmatched\r\n",
+                    po.last_err_ns, po.mean_ns, po.rms_ns, po.max_abs_ns, po.win_n, po.matched, po.unmatched);
+    }
+    if (po.freq_hz && freq_acc.n) {
+        std::printf("freqout    %u Hz: %zu rising edges (%u missed), steady vs true: mean %.0f ns  rms %.0f ns  max %.0f ns\r\n",
+                    po.freq_hz, g_out.freq.size(), po.freq_missed,
+                    freq_acc.sum / freq_acc.n, std::sqrt(freq_acc.sum2 / freq_acc.n), freq_acc.worst);
+    }
+    const Sample& last = v.back();
+    std::printf("final      servo %s  freq %d ppb (true %.0f)  steps %u  edges %u\r\n",
+                servo_state_str(last.tb.servo_state), last.tb.freq_ppb, last.true_ppb, last.tb.steps,
+                last.tb.updates);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Scenario sc{};
+    uint64_t seed = 1;
+    const char* csv_path = nullptr;
+    const char* adev_path = nullptr;
+    if (!parse_args(argc, argv, &sc, &seed, &csv_path, &adev_path)) return 2;
+
+    FILE* csv = nullptr;
+    if (csv_path) {
+        csv = std::fopen(csv_path, "w");
+        if (!csv) {
+            std::perror(csv_path);
+            return 1;
+        }
+        std::fprintf(csv, "t_s,err_ns,true_ppb,servo_ppb,servo_state,servo_offset_ns,synced,gps,stratum,bound_ns,"
+                          "temp_mc,tempco_ppb,tempco_adj_ppb\n");
+    }
+
+    Crystal xo{ &sc, std::mt19937_64(seed) };
+    std::mt19937_64 rng(seed ^ 0x9E3779B97F4A7C15ULL);
+    std::normal_distribution<double> jitter(0.0, sc.jitter_ns);
+    std::uniform_real_distribution<double> spread(0.0, sc.lat_spread_ms);
+    std::mt19937_64 temp_rng(seed ^ 0xD1B54A32D192ED03ULL);
+    std::normal_distribution<double> temp_noise(0.0, TEMP_NOISE_C);
+    std::mt19937_64 loss_rng(seed ^ 0x94D049BB133111EBULL);
+    std::uniform_real_distribution<double> loss(0.0, 100.0);
+    std::mt19937_64 glitch_rng(seed ^ 0xBF58476D1CE4E5B9ULL);
+    std::uniform_real_distribution<double> glitch_pct(0.0, 100.0);
+    std::uniform_real_distribution<double> glitch_at(0.02, 0.98);
+
+    host_time_set_us(static_cast<uint64_t>(BOOT_LOCAL_NS / 1000.0));
+    timebase_init();
+    gps_task_init();
+
+    std::vector<Sample> samples;
+    samples.reserve(sc.duration_s);
+    std::vector<Event> evs;
+    char line[128];
+
+    g_out.xo = &xo;
+    host_gpio_on_output(on_gpio_output);
+
+    for (uint32_t n = 0; n < sc.duration_s; ++n) {
+        const uint64_t utc_s = UTC_START + n;
+        g_out.n = n;
+        const bool gps_on = !sc.holdover_at_s || n < sc.holdover_at_s ||
+                            (sc.holdover_len_s && n >= sc.holdover_at_s + sc.holdover_len_s);
+        xo.begin_second(n);
+        host_temp_set_c(xo.temp_c(n) + temp_noise(temp_rng));
+
+        // This second's events, in true time
+        evs.clear();
+        for (int k = 0; k < 10; ++k) evs.push_back({ k * 0.1 + 0.05, Ev::Service, 0 });
+        evs.push_back({ 0.5, Ev::Sample, 0 });
+        if (gps_on) {
+            const double pps_dt = jitter(rng) * 1e-9;   // may land just before :00
+            if (!(sc.pps_miss_pct > 0.0 && glitch_pct(glitch_rng) < sc.pps_miss_pct)) {
+                evs.push_back({ pps_dt, Ev::Pps, 0 });
+            }
+            if (sc.pps_extra_pct > 0.0 && glitch_pct(glitch_rng) < sc.pps_extra_pct) {
+                evs.push_back({ glitch_at(glitch_rng), Ev::Pps, 0 });
+            }
+            double t = (sc.lat_ms + spread(rng)) * 1e-3;
+            const bool rmc_lost = sc.rmc_loss_pct > 0.0 && loss(loss_rng) < sc.rmc_loss_pct;
+            for (uint8_t s = 0; s < 2; ++s) {
+                t += make_sentence(line, sizeof(line), s, utc_s) * BAUD_CHAR_S;
+                if (s == 0 && rmc_lost) continue;   // garbled on the wire
+                evs.push_back({ std::fmin(t, 0.999), Ev::Nmea, s });
+            }
+        }
+        std::stable_sort(evs.begin(), evs.end(),
+                         [](const Event& a, const Event& b) { return a.dt < b.dt; });
+
+        for (const Event& e : evs) {
+            const double local = xo.local_ns(e.dt);
+            run_alarms_until(local, true);
+            host_time_set_us(static_cast<uint64_t>(local / 1000.0));
+
+            switch (e.kind) {
+                case Ev::Pps:
+                    host_gpio_edge(PPS_GPIO, GPIO_IRQ_EDGE_RISE);
+                    break;
+                case Ev::Nmea: {
+                    const size_t len = make_sentence(line, sizeof(line), e.sentence, utc_s);
+                    host_uart_rx(line, len);
+                    gps_task_poll();
+                    break;
+                }
+                case Ev::Service:
+                    gps_task_poll();
+                    break;
+                case Ev::Sample: {
+                    Sample s{};
+                    s.t_s      = n;
+                    s.true_ppb = xo.rate_ppb;
+                    timebase_get_status(&s.tb);
+                    if (!measure_err_ns(local, utc_s, e.dt, &s.err_ns)) s.err_ns = NAN;
+                    samples.push_back(s);
+                    if (csv) {
+                        std::fprintf(csv, "%u,%.1f,%.2f,%d,%s,%lld,%d,%d,%u,%lu,%d,%d,%d\n",
+                                     n, s.err_ns, s.true_ppb, s.tb.freq_ppb,
+                                     servo_state_str(s.tb.servo_state),
+                                     (long long)s.tb.last_offset_ns, s.tb.synced ? 1 : 0, gps_on ? 1 : 0,
+                                     (unsigned)s.tb.stratum, (unsigned long)s.tb.error_ns,
+                                     s.tb.tempco.temp_mc, s.tb.tempco.pred_ppb,
+                                     s.tb.tempco.hold_adj_ppb);
+                    }
+                    break;
+                }
+            }
+        }
+        run_alarms_until(xo.local_ns(1.0), false);
+        xo.end_second();
+    }
+
+    if (csv) std::fclose(csv);
+    if (!samples.empty()) report(sc, seed, samples);
+
+    if (adev_path) {
+        // Same columns as the console dump ('a' on the dashboard)
+        FILE* f = std::fopen(adev_path, "w");
+        if (!f) {
+            std::perror(adev_path);
+            return 1;
+        }
+        StabilityReport st{};
+        stability_get(&st);
+        std::fprintf(f, "tau_s,n_adev,adev,n_mdev,mdev,tdev_ns\n");
+        for (const StabilityPoint& p : st.pt) {
+            if (p.n_adev) std::fprintf(f, "%u,%u,%.3e,%u,%.3e,%.2f\n", p.tau_s, p.n_adev, p.adev, p.n_mdev, p.mdev, p.tdev_ns);
+        }
+        std::fclose(f);
+    }
+    return 0;
+}
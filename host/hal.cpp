@@ -0,0 +1,201 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "host_hal.h"
+
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/timer.h"
+#include "hardware/uart.h"
+#include "pico/platform.h"
+
+#include <chrono>
+#include <cmath>
+#include <deque>
+
+namespace {
+
+uint64_t g_now_us = 1000000;
+uint32_t g_sub_ns = 0;          // busy-waited below the microsecond
+
+bool     g_realtime     = false;
+uint64_t g_real_base_us = 0;   // steady clock at the switch to real time
+
+uint64_t steady_us() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+struct GpioIrq {
+    gpio_irq_callback_t cb = nullptr;
+    uint32_t pin_events[32] = {};
+};
+GpioIrq g_gpio;
+host_gpio_out_cb_t g_gpio_out = nullptr;
+
+struct HostAlarm {
+    bool claimed = false;
+    bool armed   = false;
+    uint64_t target_us = 0;
+    hardware_alarm_callback_t cb = nullptr;
+};
+HostAlarm g_alarms[4];
+
+irq_handler_t g_uart0_handler = nullptr;
+std::deque<uint8_t> g_uart0_fifo;
+
+// Sensor reading for 27 C: 0.706 V of 3.3 V, 12 bits
+uint16_t g_adc_temp_raw = 876;
+
+} // namespace
+
+struct uart_inst { int index; };
+static uart_inst g_uart0_inst{0};
+uart_inst_t* const host_uart0 = &g_uart0_inst;
+
+// ---- SDK side ----
+
+uint64_t time_us_64() {
+    return g_realtime ? g_now_us + (steady_us() - g_real_base_us) : g_now_us;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled,
+                                        gpio_irq_callback_t callback) {
+    if (gpio >= 32) return;
+    g_gpio.cb = callback;
+    if (enabled) g_gpio.pin_events[gpio] |= events;
+    else         g_gpio.pin_events[gpio] &= ~events;
+}
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    if (num == UART0_IRQ) g_uart0_handler = handler;
+}
+
+bool uart_is_readable(uart_inst_t* uart) {
+    return uart == host_uart0 && !g_uart0_fifo.empty();
+}
+
+char uart_getc(uart_inst_t* uart) {
+    if (uart != host_uart0 || g_uart0_fifo.empty()) return 0;
+    const uint8_t c = g_uart0_fifo.front();
+    g_uart0_fifo.pop_front();
+    return static_cast<char>(c);
+}
+
+void gpio_put(uint gpio, bool value) {
+    if (g_gpio_out) g_gpio_out(gpio, value, host_time_ns());
+}
+
+uint16_t adc_read() { return g_adc_temp_raw; }
+
+void busy_wait_until(absolute_time_t t) {
+    if (t > time_us_64()) host_time_set_us(t);
+}
+
+void busy_wait_at_least_cycles(uint32_t minimum_cycles) {
+    const uint64_t ns = g_sub_ns + static_cast<uint64_t>(minimum_cycles) * 1000000000ULL / clock_get_hz(clk_sys);
+    g_now_us += ns / 1000u;
+    g_sub_ns  = static_cast<uint32_t>(ns % 1000u);
+}
+
+int hardware_alarm_claim_unused(bool) {
+    for (int i = 0; i < 4; ++i) {
+        if (!g_alarms[i].claimed) {
+            g_alarms[i].claimed = true;
+            return i;
+        }
+    }
+    return -1;
+}
+
+void hardware_alarm_set_callback(uint alarm_num, hardware_alarm_callback_t callback) {
+    if (alarm_num < 4) g_alarms[alarm_num].cb = callback;
+}
+
+bool hardware_alarm_set_target(uint alarm_num, absolute_time_t t) {
+    if (alarm_num >= 4) return true;
+    HostAlarm& a = g_alarms[alarm_num];
+    a.armed = t > time_us_64();
+    a.target_us = t;
+    return !a.armed;
+}
+
+void hardware_alarm_cancel(uint alarm_num) {
+    if (alarm_num < 4) g_alarms[alarm_num].armed = false;
+}
+
+// ---- test side ----
+
+void host_time_set_us(uint64_t us) { g_now_us = us; g_sub_ns = 0; }
+void host_time_advance_us(uint64_t us) { g_now_us += us; g_sub_ns = 0; }
+uint64_t host_time_us() { return time_us_64(); }
+uint64_t host_time_ns() { return time_us_64() * 1000u + g_sub_ns; }
+
+bool host_alarm_next_us(uint64_t* at_us) {
+    bool any = false;
+    for (const HostAlarm& a : g_alarms) {
+        if (a.armed && (!any || a.target_us < *at_us)) {
+            *at_us = a.target_us;
+            any = true;
+        }
+    }
+    return any;
+}
+
+uint32_t host_alarm_run_due() {
+    uint32_t fired = 0;
+    uint64_t at = 0;
+    while (host_alarm_next_us(&at) && at <= time_us_64()) {
+        for (uint i = 0; i < 4; ++i) {
+            HostAlarm& a = g_alarms[i];
+            if (!a.armed || a.target_us != at) continue;
+            a.armed = false;
+            if (a.cb) a.cb(i);
+            fired++;
+            break;
+        }
+    }
+    return fired;
+}
+
+void host_time_realtime(bool on) {
+    if (on == g_realtime) return;
+    if (on) g_real_base_us = steady_us();
+    else    g_now_us = time_us_64();
+    g_realtime = on;
+}
+
+void host_gpio_on_output(host_gpio_out_cb_t cb) { g_gpio_out = cb; }
+
+bool host_gpio_edge(uint32_t gpio, uint32_t events) {
+    if (gpio >= 32 || !g_gpio.cb || !(g_gpio.pin_events[gpio] & events)) return false;
+    g_gpio.cb(gpio, events & g_gpio.pin_events[gpio]);
+    return true;
+}
+
+size_t host_uart_rx(const void* data, size_t len) {
+    if (!g_uart0_handler) return 0;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    g_uart0_fifo.insert(g_uart0_fifo.end(), p, p + len);
+    const size_t before = g_uart0_fifo.size();
+    g_uart0_handler();
+    return before - g_uart0_fifo.size();
+}
+
+void host_temp_set_c(double c) {
+    // Inverse of the datasheet approximation used by temp.cpp
+    const double v = 0.706 - (c - 27.0) * 0.001721;
+    const long raw = std::lround(v / 3.3 * 4096.0);
+    g_adc_temp_raw = static_cast<uint16_t>(raw < 0 ? 0 : (raw > 4095 ? 4095 : raw));
+}
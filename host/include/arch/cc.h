@@ -0,0 +1,34 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef HOST_ARCH_CC_H
+#define HOST_ARCH_CC_H
+
+// lwIP platform glue for the host load test (see host/CMakeLists.txt).
+// Mirrors the Pico SDK's pico_lwip arch/cc.h for a NO_SYS build.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if NO_SYS
+typedef int sys_prot_t;
+#else
+typedef uint32_t sys_prot_t;
+#endif
+
+#define LWIP_PLATFORM_DIAG(x)   do { printf x; } while (0)
+#define LWIP_PLATFORM_ASSERT(x) do { printf("lwIP assert \"%s\" at %s:%d\n", x, __FILE__, __LINE__); \
+                                     fflush(NULL); abort(); } while (0)
+
+#define LWIP_RAND() ((u32_t)rand())
+
+#endif // HOST_ARCH_CC_H
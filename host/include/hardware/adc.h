@@ -0,0 +1,21 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include "pico/types.h"
+
+// Only the temperature sensor is modelled; host_temp_set_c() sets what it reads.
+static inline void adc_init() {}
+static inline void adc_set_temp_sensor_enabled(bool) {}
+static inline void adc_select_input(uint) {}
+
+uint16_t adc_read();
@@ -0,0 +1,41 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include "pico/types.h"
+
+enum { GPIO_IN = 0, GPIO_OUT = 1 };
+
+enum gpio_irq_level {
+    GPIO_IRQ_LEVEL_LOW  = 0x1u,
+    GPIO_IRQ_LEVEL_HIGH = 0x2u,
+    GPIO_IRQ_EDGE_FALL  = 0x4u,
+    GPIO_IRQ_EDGE_RISE  = 0x8u,
+};
+
+enum gpio_function { GPIO_FUNC_UART = 2, GPIO_FUNC_SIO = 5, GPIO_FUNC_NULL = 0x1f };
+
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t event_mask);
+
+// Pin configuration is accepted and ignored.
+static inline void gpio_init(uint) {}
+static inline void gpio_set_dir(uint, bool) {}
+static inline void gpio_pull_down(uint) {}
+static inline void gpio_pull_up(uint) {}
+static inline void gpio_set_function(uint, gpio_function) {}
+
+// Output levels go to the host_gpio_on_output() hook, if any.
+void gpio_put(uint gpio, bool value);
+
+// Registers the (single, shared) GPIO callback; host_gpio_edge() fires it.
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled,
+                                        gpio_irq_callback_t callback);
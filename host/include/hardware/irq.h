@@ -0,0 +1,26 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include "pico/types.h"
+
+enum { UART0_IRQ = 20, UART1_IRQ = 21 };
+
+typedef void (*irq_handler_t)();
+
+// Only UART0_IRQ is routed (by host_uart_rx()); other handlers are stored
+// and never called.
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+static inline void irq_set_enabled(uint, bool) {}
+static inline void irq_set_priority(uint, uint8_t) {}
+
+#define PICO_LOWEST_IRQ_PRIORITY 0xc0
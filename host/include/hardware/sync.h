@@ -0,0 +1,28 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include "pico/types.h"
+
+// The host build is single-threaded and "IRQs" run synchronously from the
+// host_* injectors, so masking and spinlocks reduce to no-ops.
+
+typedef volatile uint32_t spin_lock_t;
+
+static inline uint32_t save_and_disable_interrupts() { return 0; }
+static inline void restore_interrupts(uint32_t) {}
+
+static inline uint32_t spin_lock_blocking(spin_lock_t*) { return 0; }
+static inline void spin_unlock(spin_lock_t*, uint32_t) {}
+
+static inline void __dmb() { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __wfi() {}
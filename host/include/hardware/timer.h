@@ -0,0 +1,34 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include "pico/types.h"
+
+// Virtual 1 MHz timer, advanced by the test/bench via host_time_*().
+uint64_t time_us_64();
+
+static inline uint32_t time_us_32() { return static_cast<uint32_t>(time_us_64()); }
+
+// Spinning can't wait for virtual time, so it moves it forward instead.
+void busy_wait_until(absolute_time_t t);
+
+// Hardware alarms: host_alarm_run_due() fires the callbacks whose target
+// has been reached. As on the chip, a target already in the past is
+// reported missed (true) and never fires.
+typedef void (*hardware_alarm_callback_t)(uint alarm_num);
+
+int  hardware_alarm_claim_unused(bool required);
+void hardware_alarm_set_callback(uint alarm_num, hardware_alarm_callback_t callback);
+bool hardware_alarm_set_target(uint alarm_num, absolute_time_t t);
+void hardware_alarm_cancel(uint alarm_num);
+
+static inline uint hardware_alarm_get_irq_num(uint alarm_num) { return alarm_num; }
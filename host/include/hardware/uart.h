@@ -0,0 +1,32 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include "pico/types.h"
+
+struct uart_inst;
+typedef struct uart_inst uart_inst_t;
+
+extern uart_inst_t* const host_uart0;
+#define uart0 host_uart0
+
+enum uart_parity_t { UART_PARITY_NONE, UART_PARITY_EVEN, UART_PARITY_ODD };
+
+// Line settings are ignored; the RX FIFO is fed by host_uart_rx().
+static inline uint uart_init(uart_inst_t*, uint baud) { return baud; }
+static inline void uart_set_format(uart_inst_t*, uint, uint, uart_parity_t) {}
+static inline void uart_set_hw_flow(uart_inst_t*, bool, bool) {}
+static inline void uart_set_fifo_enabled(uart_inst_t*, bool) {}
+static inline void uart_set_irq_enables(uart_inst_t*, bool, bool) {}
+
+bool uart_is_readable(uart_inst_t* uart);
+char uart_getc(uart_inst_t* uart);
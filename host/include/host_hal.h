@@ -0,0 +1,56 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Host HAL: drives the Pico SDK stand-ins in host/include from a test or
+// benchmark. Time is virtual and only moves when told to; "interrupts" run
+// synchronously on the calling thread.
+
+// Virtual time_us_64(). Starts at 1 s so 0 keeps meaning "never".
+void     host_time_set_us(uint64_t us);
+void     host_time_advance_us(uint64_t us);
+uint64_t host_time_us();
+
+// Real-time mode: time_us_64() follows the host's monotonic clock, carrying
+// on from the current virtual time, until switched off again.
+void host_time_realtime(bool on);
+
+// Virtual time in ns: the microsecond counter plus whatever
+// busy_wait_at_least_cycles() has added since it last moved.
+uint64_t host_time_ns();
+
+// Earliest armed hardware alarm target (time_us_64() units).
+bool host_alarm_next_us(uint64_t* at_us);
+
+// Fire every alarm whose target is <= the current virtual time, in target
+// order (callbacks may re-arm). Returns the number fired.
+uint32_t host_alarm_run_due();
+
+// Fire the registered GPIO IRQ callback at the current virtual time.
+// Returns false if nothing is registered for that pin/event.
+bool host_gpio_edge(uint32_t gpio, uint32_t events);
+
+// Called on every gpio_put() with the level and host_time_ns().
+typedef void (*host_gpio_out_cb_t)(uint32_t gpio, bool level, uint64_t at_ns);
+void host_gpio_on_output(host_gpio_out_cb_t cb);
+
+// Queue bytes into the fake UART0 RX FIFO and run its IRQ handler, which
+// drains the FIFO as the real one would. Returns the number of bytes the
+// handler consumed (0 if none is installed).
+size_t host_uart_rx(const void* data, size_t len);
+
+// Die temperature the ADC's sensor channel reports (quantized to 12 bits,
+// ~0.47 C per count, as on the chip).
+void host_temp_set_c(double c);
@@ -0,0 +1,26 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+// NO_SYS hooks lwIP needs from the platform, on the host HAL clock.
+
+#include "lwip/opt.h"
+#include "lwip/sys.h"
+
+#include "hardware/timer.h"
+
+extern "C" u32_t sys_now(void) {
+    return static_cast<u32_t>(time_us_64() / 1000u);
+}
+
+// Single-threaded: lwIP is only ever entered from the load generator.
+extern "C" sys_prot_t sys_arch_protect(void) { return 0; }
+extern "C" void sys_arch_unprotect(sys_prot_t) {}
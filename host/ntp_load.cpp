@@ -0,0 +1,332 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// NTP load generator for the real server code (ntp_server.cpp) running in
+// lwIP on the host, with the firmware's lwipopts.h.
+//
+// An in-process IPv4 netif stands in for the cyw43 interface: requests are
+// built as complete IPv4/UDP frames in PBUF_POOL buffers (as the Wi-Fi driver
+// does) and handed to netif->input, so the RX stamp, the fast-path hook and
+// udp_recv all see them exactly as on the Pico. Replies come back through
+// netif->output and are checked and timed there.
+//
+// Usage: ntp_load [--rate N/s (0 = flat out)] [--seconds S] [--burst B]
+//                 [--clients C]
+
+#include "host_hal.h"
+#include "ntp_packet.h"
+#include "ntp_server.h"
+#include "timebase.h"
+
+#include "lwip/init.h"
+#include "lwip/inet_chksum.h"
+#include "lwip/ip4.h"
+#include "lwip/memp.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/stats.h"
+#include "lwip/timeouts.h"
+#include "lwip/prot/ip4.h"
+#include "lwip/prot/udp.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint16_t NTP_PORT   = 123;
+constexpr uint16_t FRAME_LEN  = IP_HLEN + UDP_HLEN + sizeof(NtpPacket);
+constexpr uint32_t MAX_BURST  = 256;
+constexpr uint64_t UTC_START  = 1790000000ULL;
+
+struct Options {
+    uint32_t rate    = 5000;    // requests per second, 0 = as fast as possible
+    uint32_t seconds = 10;
+    uint32_t burst   = 8;       // frames queued before lwIP sees any of them
+    uint32_t clients = 20000;
+};
+
+// Log2 histogram in nanoseconds (LatencyHist is in microseconds, too coarse
+// for host service times). Bin 0 holds 0 ns, bin i holds [2^(i-1), 2^i) ns,
+// the last bin everything from 2^31.
+constexpr uint32_t NS_HIST_BINS = 33;
+
+struct NsHist {
+    uint64_t bins[NS_HIST_BINS] = {};
+    uint64_t count  = 0;
+    uint32_t max_ns = 0;
+};
+
+void ns_hist_add(NsHist* h, uint32_t ns) {
+    uint32_t bin = 0;
+    while (bin < NS_HIST_BINS - 1 && (static_cast<uint64_t>(ns) >> bin)) ++bin;
+    h->bins[bin]++;
+    h->count++;
+    if (ns > h->max_ns) h->max_ns = ns;
+}
+
+// Upper edge (ns) of the bin holding the pct-th percentile; 0 if empty.
+uint32_t ns_hist_percentile(const NsHist* h, uint32_t pct) {
+    if (h->count == 0) return 0;
+    const uint64_t want = (h->count * pct + 99u) / 100u;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < NS_HIST_BINS; ++i) {
+        seen += h->bins[i];
+        if (seen >= want) return (i == NS_HIST_BINS - 1) ? h->max_ns : (1u << i);
+    }
+    return h->max_ns;
+}
+
+struct LoadStats {
+    uint64_t sent      = 0;
+    uint64_t rx_nobuf  = 0;     // PBUF_POOL empty: the driver would drop it
+    uint64_t replies   = 0;
+    uint64_t kod       = 0;
+    uint64_t malformed = 0;
+    NsHist   t3_t2_ns{};        // from the reply's receive/transmit stamps
+    NsHist   service_ns{};      // netif input -> reply at netif output
+};
+
+netif     g_nif;
+LoadStats g_load;
+Clock::time_point g_input_at;
+
+inline int64_t ns_since(Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t).count();
+}
+
+// NTP 32.32 difference -> ns
+inline uint32_t ntp_diff_ns(uint32_t s0, uint32_t f0, uint32_t s1, uint32_t f1) {
+    const uint64_t a = (static_cast<uint64_t>(s0) << 32) | f0;
+    const uint64_t b = (static_cast<uint64_t>(s1) << 32) | f1;
+    if (b < a) return 0;
+    const uint64_t d = b - a;
+    if (d >> 32) return UINT32_MAX;
+    return static_cast<uint32_t>((d * 1000000000ULL) >> 32);
+}
+
+// Reply path (both the fast path and udp_sendto end here). p starts at the
+// IP header; lwIP frees it after we return.
+err_t loadif_output(netif*, pbuf* p, const ip4_addr_t*) {
+    const int64_t service = ns_since(g_input_at);
+
+    uint8_t frame[FRAME_LEN];
+    if (pbuf_copy_partial(p, frame, FRAME_LEN, 0) != FRAME_LEN) {
+        g_load.malformed++;
+        return ERR_OK;
+    }
+    const auto* udph = reinterpret_cast<const udp_hdr*>(frame + IP_HLEN);
+    NtpPacket rsp;
+    std::memcpy(&rsp, frame + IP_HLEN + UDP_HLEN, sizeof(rsp));
+    if (udph->src != PP_HTONS(NTP_PORT) || (rsp.li_vn_mode & 0x07u) != 4u) {
+        g_load.malformed++;
+        return ERR_OK;
+    }
+
+    if (rsp.stratum == 0) {
+        g_load.kod++;
+        return ERR_OK;
+    }
+
+    g_load.replies++;
+    ns_hist_add(&g_load.service_ns, service > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(service));
+    ns_hist_add(&g_load.t3_t2_ns, ntp_diff_ns(hton32(rsp.recv_ts_s), hton32(rsp.recv_ts_f),
+                                              hton32(rsp.tx_ts_s), hton32(rsp.tx_ts_f)));
+    return ERR_OK;
+}
+
+err_t loadif_init(netif* n) {
+    n->name[0] = 'l';
+    n->name[1] = 'd';
+    n->mtu     = 1500;
+    n->output  = loadif_output;
+    return ERR_OK;
+}
+
+// A mode-3 request from client `idx` (10.1.0.0/16 + idx), as a complete
+// IPv4/UDP frame in a pool pbuf. nullptr when the pool is empty.
+pbuf* make_request(uint32_t idx, uint32_t seq) {
+    pbuf* p = pbuf_alloc(PBUF_RAW, FRAME_LEN, PBUF_POOL);
+    if (!p) return nullptr;
+
+    ip4_addr_t src, dst;
+    ip4_addr_set_u32(&src, lwip_htonl(0x0A010000u + (idx & 0xFFFFu)));
+    ip4_addr_copy(dst, *netif_ip4_addr(&g_nif));
+
+    auto* iph  = static_cast<ip_hdr*>(p->payload);
+    auto* udph = reinterpret_cast<udp_hdr*>(static_cast<uint8_t*>(p->payload) + IP_HLEN);
+    auto* req  = reinterpret_cast<NtpPacket*>(reinterpret_cast<uint8_t*>(udph) + UDP_HLEN);
+
+    std::memset(req, 0, sizeof(*req));
+    req->li_vn_mode = ntp_make_li_vn_mode(0, 4, 3);
+    req->tx_ts_s = hton32(seq);
+    req->tx_ts_f = hton32(idx);
+
+    udph->src    = lwip_htons(static_cast<u16_t>(1024u + (idx % 60000u)));
+    udph->dest   = PP_HTONS(NTP_PORT);
+    udph->len    = PP_HTONS(UDP_HLEN + sizeof(NtpPacket));
+    udph->chksum = 0;
+
+    IPH_VHL_SET(iph, 4, IP_HLEN / 4);
+    IPH_TOS_SET(iph, 0);
+    IPH_LEN_SET(iph, PP_HTONS(FRAME_LEN));
+    IPH_ID_SET(iph, lwip_htons(static_cast<u16_t>(seq)));
+    IPH_OFFSET_SET(iph, 0);
+    IPH_TTL_SET(iph, 64);
+    IPH_PROTO_SET(iph, IP_PROTO_UDP);
+    ip4_addr_copy(iph->src, src);
+    ip4_addr_copy(iph->dest, dst);
+    IPH_CHKSUM_SET(iph, 0);
+    IPH_CHKSUM_SET(iph, inet_chksum(iph, IP_HLEN));
+
+    // Real clients send a UDP checksum; the server verifies it.
+    pbuf_remove_header(p, IP_HLEN);
+    u16_t sum = inet_chksum_pseudo(p, IP_PROTO_UDP, p->tot_len, &src, &dst);
+    if (sum == 0) sum = 0xFFFF;
+    udph->chksum = sum;
+    pbuf_add_header(p, IP_HLEN);
+    return p;
+}
+
+bool parse_args(int argc, char** argv, Options* o) {
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "missing value for %s\n", argv[i]);
+            return false;
+        }
+        const uint32_t v = static_cast<uint32_t>(std::strtoul(argv[i + 1], nullptr, 0));
+        if      (!std::strcmp(argv[i], "--rate"))    o->rate = v;
+        else if (!std::strcmp(argv[i], "--seconds")) o->seconds = v;
+        else if (!std::strcmp(argv[i], "--burst"))   o->burst = v;
+        else if (!std::strcmp(argv[i], "--clients")) o->clients = v;
+        else {
+            std::fprintf(stderr, "unknown option %s\n", argv[i]);
+            return false;
+        }
+    }
+    if (o->burst < 1) o->burst = 1;
+    if (o->burst > MAX_BURST) o->burst = MAX_BURST;
+    if (o->clients < 1) o->clients = 1;
+    if (o->seconds < 1) o->seconds = 1;
+    return true;
+}
+
+void print_hist(const char* label, const NsHist* h) {
+    std::printf("  %-20s p50 %7lu  p90 %7lu  p99 %7lu  max %7lu ns\r\n", label,
+                (unsigned long)ns_hist_percentile(h, 50), (unsigned long)ns_hist_percentile(h, 90),
+                (unsigned long)ns_hist_percentile(h, 99), (unsigned long)h->max_ns);
+}
+
+void print_pools() {
+#if LWIP_STATS && MEMP_STATS
+    std::printf("  lwIP pools (high water / size, alloc errors):\r\n");
+    for (int i = 0; i < MEMP_MAX; ++i) {
+        const stats_mem* m = lwip_stats.memp[i];
+        if (!m || (m->max == 0 && m->err == 0)) continue;
+        std::printf("    %-16s %4lu / %-4lu  err %lu\r\n", m->name,
+                    (unsigned long)m->max, (unsigned long)m->avail, (unsigned long)m->err);
+    }
+#endif
+#if LWIP_STATS && MEM_STATS
+    std::printf("    %-16s %4lu / %-4lu  err %lu  (heap bytes)\r\n", "MEM",
+                (unsigned long)lwip_stats.mem.max, (unsigned long)lwip_stats.mem.avail,
+                (unsigned long)lwip_stats.mem.err);
+#endif
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, &opt)) return 2;
+
+    host_time_realtime(true);
+    timebase_init();
+    timebase_on_gps_utc_unix(UTC_START);   // coarse fix: enough to serve
+
+    lwip_init();
+    ip4_addr_t ip, mask, gw;
+    IP4_ADDR(&ip, 10, 0, 0, 1);
+    IP4_ADDR(&mask, 255, 0, 0, 0);
+    IP4_ADDR(&gw, 10, 0, 0, 254);
+    netif_add(&g_nif, &ip, &mask, &gw, nullptr, loadif_init, ip4_input);
+    netif_set_default(&g_nif);
+    netif_set_up(&g_nif);
+    netif_set_link_up(&g_nif);
+
+    ntp_server_init();
+    if (!ntp_server_is_running()) {
+        std::fprintf(stderr, "ntp_server_init failed\n");
+        return 1;
+    }
+
+    const auto start = Clock::now();
+    const auto stop  = start + std::chrono::seconds(opt.seconds);
+    const auto tick  = opt.rate ? std::chrono::nanoseconds(1000000000ULL * opt.burst / opt.rate)
+                                : std::chrono::nanoseconds(0);
+    auto next = start;
+    uint32_t seq = 0;
+    pbuf* queued[MAX_BURST];
+
+    while (Clock::now() < stop) {
+        // Frames pile up in the driver, then lwIP drains them back to back.
+        uint32_t n = 0;
+        for (uint32_t i = 0; i < opt.burst; ++i, ++seq) {
+            g_load.sent++;
+            pbuf* p = make_request(seq % opt.clients, seq);
+            if (p) queued[n++] = p;
+            else   g_load.rx_nobuf++;
+        }
+        for (uint32_t i = 0; i < n; ++i) {
+            g_input_at = Clock::now();
+            if (g_nif.input(queued[i], &g_nif) != ERR_OK) pbuf_free(queued[i]);
+        }
+        sys_check_timeouts();
+        timebase_service();
+
+        if (opt.rate) {
+            next += tick;
+            std::this_thread::sleep_until(next);
+        }
+    }
+    const double secs = static_cast<double>(ns_since(start)) / 1e9;
+
+    NtpServerStats s;
+    ntp_server_get_stats(&s);
+
+    const uint64_t missing = g_load.sent - g_load.replies - g_load.kod;
+    std::printf("ntp_load: %llu requests in %.1f s (%.0f/s, %s), burst %lu, %lu clients\r\n",
+                (unsigned long long)g_load.sent, secs, g_load.sent / secs,
+                opt.rate ? "paced" : "flat out", (unsigned long)opt.burst,
+                (unsigned long)opt.clients);
+    std::printf("  replies %llu (%.2f%%)  kod %llu  no reply %llu  (rx no-buf %llu, malformed %llu)\r\n",
+                (unsigned long long)g_load.replies,
+                g_load.sent ? 100.0 * g_load.replies / g_load.sent : 0.0,
+                (unsigned long long)g_load.kod, (unsigned long long)missing,
+                (unsigned long long)g_load.rx_nobuf, (unsigned long long)g_load.malformed);
+    print_hist("T3-T2 (reply)", &g_load.t3_t2_ns);
+    print_hist("input -> output", &g_load.service_ns);
+    std::printf("  server: rx %lu tx %lu fast %lu in-place %lu copied %lu fallback %lu\r\n",
+                (unsigned long)s.rx, (unsigned long)s.tx, (unsigned long)s.fast_path,
+                (unsigned long)s.in_place, (unsigned long)s.copied, (unsigned long)s.fast_fallback);
+    std::printf("          dropped %lu rate-limited %lu alloc-fail %lu unstamped %lu\r\n",
+                (unsigned long)s.dropped, (unsigned long)s.rate_limited,
+                (unsigned long)s.alloc_failures, (unsigned long)s.rx_unstamped);
+    print_pools();
+    return 0;
+}
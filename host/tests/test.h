@@ -0,0 +1,56 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <cstdint>
+#include <cstdio>
+
+// Minimal checks for the host tests: a failed CHECK prints where and why and
+// marks the running test failed, but lets it carry on so one run reports
+// everything that is wrong.
+
+void test_fail(const char* file, int line, const char* what);
+
+#define CHECK(cond) \
+    do { if (!(cond)) test_fail(__FILE__, __LINE__, #cond); } while (0)
+
+// a == b for anything that converts to long long; prints both values.
+#define CHECK_EQ(a, b) \
+    do { \
+        const long long va_ = static_cast<long long>(a); \
+        const long long vb_ = static_cast<long long>(b); \
+        if (va_ != vb_) { \
+            char msg_[160]; \
+            std::snprintf(msg_, sizeof(msg_), "%s == %s (%lld vs %lld)", #a, #b, va_, vb_); \
+            test_fail(__FILE__, __LINE__, msg_); \
+        } \
+    } while (0)
+
+// One test per ctest entry: `ntp_tests <name>` runs it, no argument runs all.
+typedef void (*test_fn_t)();
+
+struct TestCase {
+    const char* name;
+    test_fn_t   fn;
+};
+
+// Each test_*.cpp defines its list.
+extern const TestCase k_packet_tests[];
+extern const TestCase k_servo_tests[];
+extern const TestCase k_seq_ring_tests[];
+extern const TestCase k_gps_line_tests[];
+extern const TestCase k_nmea_tests[];
+extern const TestCase k_client_log_tests[];
+extern const TestCase k_timebase_tests[];
+extern const TestCase k_pps_stats_tests[];
+extern const TestCase k_tempco_tests[];
+extern const TestCase k_stability_tests[];
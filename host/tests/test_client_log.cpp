@@ -0,0 +1,154 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+// client_log: the per-client token bucket, KoD spacing, probing within a
+// home slot's window and LRU eviction when the window is full.
+
+#include "test.h"
+#include "client_log.h"
+
+namespace {
+
+constexpr uint32_t INTERVAL = 100;   // ticks per request, sustained
+constexpr uint32_t BURST    = 4;
+
+// The n-th smallest address whose first probe is `slot`.
+uint32_t addr_at(uint32_t slot, uint32_t n) {
+    for (uint32_t a = 1;; ++a) {
+        if (client_log_home_slot(a) == slot && n-- == 0) return a;
+    }
+}
+
+int allowed(ClientEntry* e, uint32_t now, uint32_t requests) {
+    int n = 0;
+    for (uint32_t i = 0; i < requests; ++i) n += client_log_allow(e, now, INTERVAL, BURST);
+    return n;
+}
+
+void burst_then_refill() {
+    client_log_clear();
+    ClientEntry* e = client_log_get(0x0A000001);
+    CHECK(e != nullptr);
+
+    // A new client gets the whole burst at once, then nothing more.
+    const uint32_t t0 = 5000;
+    CHECK_EQ(allowed(e, t0, BURST + 3), BURST);
+
+    // Credit comes back at one request per interval...
+    CHECK_EQ(allowed(e, t0 + INTERVAL - 1, 1), 0);
+    CHECK_EQ(allowed(e, t0 + INTERVAL, 2), 1);
+    CHECK_EQ(allowed(e, t0 + 3 * INTERVAL + INTERVAL / 2, 3), 2);
+
+    // ...and is capped at the burst however long the client stays away,
+    // including across the tick counter wrapping.
+    CHECK_EQ(allowed(e, t0 + 1000 * INTERVAL, BURST + 1), BURST);
+    e->last_tick = 0xFFFFFFFFu - INTERVAL / 2;
+    CHECK_EQ(allowed(e, INTERVAL / 2, 2), 1);
+}
+
+void kod_threshold() {
+    client_log_clear();
+    ClientEntry* e = client_log_get(0x0A000002);
+    const uint32_t t0 = 5000;
+    CHECK_EQ(allowed(e, t0, BURST), BURST);
+
+    // First refusal earns a KoD; further ones within the interval do not.
+    CHECK(!client_log_allow(e, t0 + 1, INTERVAL, BURST));
+    CHECK(client_log_kod_due(e, t0 + 1, INTERVAL));
+    CHECK(!client_log_kod_due(e, t0 + 2, INTERVAL));
+    CHECK(!client_log_kod_due(e, t0 + INTERVAL, INTERVAL));
+    CHECK(client_log_kod_due(e, t0 + 1 + INTERVAL, INTERVAL));
+    CHECK(!client_log_kod_due(nullptr, t0, INTERVAL));
+}
+
+void probe_collisions() {
+    client_log_clear();
+
+    // A full window of clients sharing one home slot are all resident,
+    // each in its own entry, without evicting anything.
+    const uint32_t home = 7;
+    ClientEntry* slot[CLIENT_LOG_PROBE];
+    for (uint32_t i = 0; i < CLIENT_LOG_PROBE; ++i) {
+        slot[i] = client_log_get(addr_at(home, i));
+        CHECK(slot[i] != nullptr);
+        CHECK_EQ(slot[i]->addr, addr_at(home, i));
+        for (uint32_t j = 0; j < i; ++j) CHECK(slot[j] != slot[i]);
+    }
+    for (uint32_t i = 0; i < CLIENT_LOG_PROBE; ++i) {
+        CHECK(client_log_find(addr_at(home, i)) == slot[i]);
+    }
+
+    // Entries are consecutive from the home slot, and state sticks.
+    CHECK_EQ(slot[CLIENT_LOG_PROBE - 1] - slot[0], CLIENT_LOG_PROBE - 1);
+    slot[3]->credit = 1234;
+    CHECK_EQ(client_log_get(addr_at(home, 3))->credit, 1234);
+
+    ClientLogStats st;
+    client_log_get_stats(&st);
+    CHECK_EQ(st.resident, CLIENT_LOG_PROBE);
+    CHECK_EQ(st.inserts, CLIENT_LOG_PROBE);
+    CHECK_EQ(st.evictions, 0);
+
+    // A neighbour whose home is taken probes on past the window's clients.
+    CHECK(client_log_find(addr_at(home + 1, 0)) == nullptr);
+    ClientEntry* n = client_log_get(addr_at(home + 1, 0));
+    CHECK_EQ(n - slot[0], CLIENT_LOG_PROBE);
+    CHECK(client_log_find(0) == nullptr);
+    CHECK(client_log_get(0) == nullptr);
+}
+
+void evicts_oldest_when_full() {
+    client_log_clear();
+
+    // One client per home slot fills the table without collisions.
+    ClientEntry* at[CLIENT_LOG_SIZE];
+    for (uint32_t s = 0; s < CLIENT_LOG_SIZE; ++s) at[s] = client_log_get(addr_at(s, 0));
+    for (uint32_t s = 1; s < CLIENT_LOG_SIZE; ++s) CHECK_EQ(at[s] - at[0], s);
+    ClientLogStats st;
+    client_log_get_stats(&st);
+    CHECK_EQ(st.resident, CLIENT_LOG_SIZE);
+    CHECK_EQ(st.evictions, 0);
+
+    // The window for home slot SIZE-3 wraps around the end of the table.
+    // Use every client in it except the one at SIZE-1, which is then the
+    // least recently used even though it was not inserted first.
+    const uint32_t home = CLIENT_LOG_SIZE - 3;
+    for (uint32_t i = 0; i < CLIENT_LOG_PROBE; ++i) {
+        const uint32_t s = (home + i) % CLIENT_LOG_SIZE;
+        if (s != CLIENT_LOG_SIZE - 1) CHECK(client_log_find(addr_at(s, 0)) == at[s]);
+    }
+
+    const uint32_t newcomer = addr_at(home, 1);
+    ClientEntry* e = client_log_get(newcomer);
+    CHECK(e == at[CLIENT_LOG_SIZE - 1]);
+    CHECK_EQ(e->addr, newcomer);
+    CHECK(!e->bucket_init);
+    CHECK(client_log_find(addr_at(CLIENT_LOG_SIZE - 1, 0)) == nullptr);
+
+    client_log_get_stats(&st);
+    CHECK_EQ(st.resident, CLIENT_LOG_SIZE);
+    CHECK_EQ(st.evictions, 1);
+
+    // Next in line is the window's least recently used client: the one at
+    // the home slot, the first used above (the newcomer is newer still).
+    CHECK(client_log_get(addr_at(home, 2)) == at[home]);
+}
+
+} // namespace
+
+extern const TestCase k_client_log_tests[] = {
+    {"burst_then_refill",       burst_then_refill},
+    {"kod_threshold",           kod_threshold},
+    {"probe_collisions",        probe_collisions},
+    {"evicts_oldest_when_full", evicts_oldest_when_full},
+    {nullptr, nullptr},
+};
@@ -0,0 +1,147 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+// GPS line extraction (gps_uart.cpp, IRQ-mode ring on the host): the
+// incremental scan, in-place views across the ring wrap, and the
+// truncation/overflow accounting.
+
+#include "test.h"
+#include "gps_uart.h"
+#include "host_hal.h"
+
+#include <cstring>
+#include <string>
+
+namespace {
+
+void feed(const std::string& s) { (void)host_uart_rx(s.data(), s.size()); }
+
+std::string view_str(const GpsLineView& v) {
+    std::string s(v.seg[0], v.len[0]);
+    if (v.len[1]) s.append(v.seg[1], v.len[1]);
+    return s;
+}
+
+GpsUartStats stats() {
+    GpsUartStats st;
+    GpsUart::get_stats(&st);
+    return st;
+}
+
+void reset() { GpsUart::init(); }
+
+void partial_then_complete() {
+    reset();
+    GpsLineView v;
+    feed("$GPZDA,1413");
+    CHECK(!GpsUart::next_line(&v));
+    feed("20.00,21,09,2026,,*6B\r");
+    CHECK(!GpsUart::next_line(&v));              // CR alone doesn't end a line
+    feed("\n$GPG");
+    CHECK(GpsUart::next_line(&v));
+    CHECK(view_str(v) == "$GPZDA,141320.00,21,09,2026,,*6B");
+    CHECK_EQ(v.len[1], 0);
+    CHECK_EQ(v.seg[0][v.len[0]], '\0');          // one span is a C string
+
+    // Same line until released
+    GpsLineView again;
+    CHECK(GpsUart::next_line(&again));
+    CHECK(again.seg[0] == v.seg[0]);
+    CHECK(GpsUart::release_line());
+    CHECK(!GpsUart::release_line());
+    CHECK(!GpsUart::next_line(&v));
+    CHECK_EQ(stats().lines, 1);
+}
+
+void byte_by_byte() {
+    reset();
+    const std::string lines[] = {"$GNRMC,1,A*00", "", "$GNGGA,2*00", "bare LF line"};
+    std::string all;
+    for (const std::string& l : lines) all += l + ((l == "bare LF line") ? "\n" : "\r\n");
+
+    uint32_t got = 0;
+    char out[GPS_LINE_MAX + 1];
+    for (char c : all) {
+        feed(std::string(1, c));
+        while (GpsUart::get_line(out, sizeof(out))) {
+            CHECK(got < 4 && lines[got] == out);
+            got++;
+        }
+    }
+    CHECK_EQ(got, 4);
+}
+
+// A line straddling the end of the ring comes back as two spans.
+void wraps_around_ring() {
+    reset();
+    char out[GPS_LINE_MAX + 1];
+    const std::string filler(99, 'x');
+    uint32_t fed = 0;
+    while (fed < 2048 - 50) {                    // RB_SIZE is 2 KiB
+        feed(filler + "\n");
+        fed += 100;
+        CHECK(GpsUart::get_line(out, sizeof(out)));
+    }
+    const std::string line = "$GNRMC,141320.000,A,4807.0380,N,01131.0000,E,0.02,211.35,210926,,,A*7F";
+    feed(line + "\r\n");
+
+    GpsLineView v;
+    CHECK(GpsUart::next_line(&v));
+    CHECK(v.len[1] != 0);
+    CHECK(view_str(v) == line);
+    CHECK_EQ(gps_line_copy(&v, out, sizeof(out)), line.size());
+    CHECK(line == out);
+    CHECK(GpsUart::release_line());
+}
+
+void overlong_line_truncated() {
+    reset();
+    char out[GPS_LINE_MAX + 1];
+    feed(std::string(GPS_LINE_MAX + 1, 'y') + "\r\n$GNZDA*00\r\n");
+    CHECK(GpsUart::get_line(out, sizeof(out)));
+    CHECK(std::strcmp(out, "$GNZDA*00") == 0);
+    CHECK_EQ(stats().truncated, 1);
+
+    // Also when the newline is still missing: dropped once it can't fit.
+    feed(std::string(GPS_LINE_MAX + 3, 'z'));
+    CHECK(!GpsUart::get_line(out, sizeof(out)));
+    CHECK_EQ(stats().truncated, 2);
+}
+
+// The IRQ drain drops what doesn't fit rather than overwrite unread data.
+void overflow_counted() {
+    reset();
+    const std::string line = std::string(99, 'o') + "\n";
+    for (int i = 0; i < 25; ++i) feed(line);     // 2500 bytes into 2048
+    const GpsUartStats st = stats();
+    CHECK_EQ(st.bytes, 2048);
+    CHECK_EQ(st.overflow, 2500 - 2048);
+
+    char out[GPS_LINE_MAX + 1];
+    uint32_t n = 0;
+    while (GpsUart::get_line(out, sizeof(out))) {
+        CHECK_EQ(std::strlen(out), 99);
+        n++;
+    }
+    CHECK_EQ(n, 20);
+}
+
+} // namespace
+
+extern const TestCase k_gps_line_tests[] = {
+    {"partial_then_complete",   partial_then_complete},
+    {"byte_by_byte",            byte_by_byte},
+    {"wraps_around_ring",       wraps_around_ring},
+    {"overlong_line_truncated", overlong_line_truncated},
+    {"overflow_counted",        overflow_counted},
+    {nullptr, nullptr},
+};
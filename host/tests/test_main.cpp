@@ -0,0 +1,72 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+// Host unit tests for ntp_core, run by ctest (one process per suite, since
+// the timebase, PPS and UART modules are singletons).
+
+#include "test.h"
+
+#include <cstring>
+
+namespace {
+
+int g_failures = 0;
+
+struct Suite {
+    const char*     name;
+    const TestCase* cases;
+};
+
+const Suite k_suites[] = {
+    {"packet", k_packet_tests},
+    {"servo",  k_servo_tests},
+    {"seq_ring", k_seq_ring_tests},
+    {"gps_line", k_gps_line_tests},
+    {"nmea",     k_nmea_tests},
+    {"client_log", k_client_log_tests},
+    {"timebase", k_timebase_tests},
+    {"pps_stats", k_pps_stats_tests},
+    {"tempco", k_tempco_tests},
+    {"stability", k_stability_tests},
+};
+
+int run_suite(const Suite& s) {
+    const int before = g_failures;
+    for (const TestCase* t = s.cases; t->name; ++t) {
+        const int f = g_failures;
+        t->fn();
+        std::printf("%-6s %s.%s\n", (g_failures == f) ? "ok" : "FAIL", s.name, t->name);
+    }
+    return g_failures - before;
+}
+
+} // namespace
+
+void test_fail(const char* file, int line, const char* what) {
+    g_failures++;
+    std::printf("  %s:%d: check failed: %s\n", file, line, what);
+}
+
+int main(int argc, char** argv) {
+    bool found = false;
+    for (const Suite& s : k_suites) {
+        if (argc > 1 && std::strcmp(argv[1], s.name) != 0) continue;
+        found = true;
+        run_suite(s);
+    }
+    if (!found) {
+        std::printf("unknown suite '%s'\n", argv[1]);
+        return 2;
+    }
+    std::printf("%d failure(s)\n", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,222 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+// NMEA tokenizer and field parsers (nmea.cpp), sentence dispatch (gps_state.cpp).
+
+#include "test.h"
+#include "nmea.h"
+#include "gps_state.h"
+
+#include <cstring>
+
+namespace {
+
+// "$<body>*hh" with the correct checksum (hex case as given).
+const char* with_checksum(const char* body, bool lower = false) {
+    static char buf[128];
+    uint8_t sum = 0;
+    for (const char* p = body; *p; ++p) sum ^= static_cast<uint8_t>(*p);
+    std::snprintf(buf, sizeof(buf), lower ? "$%s*%02x" : "$%s*%02X", body, sum);
+    return buf;
+}
+
+bool field_is(const NmeaField& f, const char* s) {
+    return f.len == std::strlen(s) && std::memcmp(f.p, s, f.len) == 0;
+}
+
+void fields_split() {
+    NmeaSentence s;
+    CHECK(nmea_tokenize(with_checksum("GNGGA,141320.000,,N,1,,"), &s) == NmeaResult::Ok);
+    CHECK_EQ(s.count, 7);
+    CHECK(field_is(s.at(0), "GNGGA"));
+    CHECK(field_is(s.at(1), "141320.000"));
+    CHECK(s.empty(2));
+    CHECK(field_is(s.at(3), "N"));
+    CHECK(field_is(s.at(4), "1"));
+    CHECK(s.empty(5));
+    CHECK(s.empty(6));
+    CHECK(s.empty(7));                  // past the end
+}
+
+void line_endings_ignored() {
+    char line[160];
+    std::snprintf(line, sizeof(line), "%s\r\n", with_checksum("GPZDA,141320.00,21,09,2026,,"));
+    NmeaSentence s;
+    CHECK(nmea_tokenize(line, &s) == NmeaResult::Ok);
+    CHECK_EQ(s.count, 7);
+}
+
+void checksum_checked() {
+    NmeaSentence s;
+    CHECK(nmea_tokenize(with_checksum("GPRMC,141320.00,A", true), &s) == NmeaResult::Ok);
+
+    char line[128];
+    std::strcpy(line, with_checksum("GPRMC,141320.00,A"));
+    line[8] = '2';                      // 141320 -> 142320
+    CHECK(nmea_tokenize(line, &s) == NmeaResult::BadChecksum);
+
+    CHECK(nmea_tokenize("$GPRMC,141320.00,A", &s) == NmeaResult::NoChecksum);
+    CHECK(nmea_tokenize("$GPRMC,141320.00,A*", &s) == NmeaResult::NoChecksum);
+    CHECK(nmea_tokenize("$GPRMC,141320.00,A*4G", &s) == NmeaResult::NoChecksum);
+}
+
+void not_nmea() {
+    NmeaSentence s;
+    CHECK(nmea_tokenize("GPRMC,141320.00,A*00", &s) == NmeaResult::NotNmea);
+    CHECK(nmea_tokenize("", &s) == NmeaResult::NotNmea);
+    CHECK(nmea_tokenize(nullptr, &s) == NmeaResult::NotNmea);
+}
+
+void too_many_fields() {
+    char body[128] = "GPGSV";
+    for (uint32_t i = 1; i < NMEA_MAX_FIELDS; ++i) std::strcat(body, ",1");
+    NmeaSentence s;
+    CHECK(nmea_tokenize(with_checksum(body), &s) == NmeaResult::Ok);
+    CHECK_EQ(s.count, NMEA_MAX_FIELDS);
+
+    std::strcat(body, ",1");
+    CHECK(nmea_tokenize(with_checksum(body), &s) == NmeaResult::TooManyFields);
+}
+
+NmeaField fld(const char* s) { return NmeaField{s, static_cast<uint32_t>(std::strlen(s))}; }
+
+void parse_u32() {
+    uint32_t v = 0;
+    CHECK(nmea_parse_u32(fld("08"), &v));
+    CHECK_EQ(v, 8);
+    CHECK(nmea_parse_u32(fld("4294967295"), &v));
+    CHECK_EQ(v, 4294967295u);
+    CHECK(!nmea_parse_u32(fld("4294967296"), &v));
+    CHECK(!nmea_parse_u32(fld(""), &v));
+    CHECK(!nmea_parse_u32(fld("1.5"), &v));
+    CHECK(!nmea_parse_u32(fld("-1"), &v));
+    CHECK(!nmea_parse_u32(fld("12a"), &v));
+}
+
+void parse_fixed() {
+    int32_t v = 0;
+    CHECK(nmea_parse_fixed(fld("0.95"), 2, &v));
+    CHECK_EQ(v, 95);
+    CHECK(nmea_parse_fixed(fld("12"), 2, &v));
+    CHECK_EQ(v, 1200);
+    CHECK(nmea_parse_fixed(fld("1.239"), 2, &v));    // truncated
+    CHECK_EQ(v, 123);
+    CHECK(nmea_parse_fixed(fld("7."), 1, &v));
+    CHECK_EQ(v, 70);
+    CHECK(!nmea_parse_fixed(fld(".5"), 1, &v));
+    CHECK(!nmea_parse_fixed(fld("1.2.3"), 1, &v));
+    CHECK(!nmea_parse_fixed(fld("3000000000"), 0, &v));
+    CHECK(!nmea_parse_fixed(fld("1"), 10, &v));
+}
+
+void parse_time_date() {
+    int32_t ms = 0;
+    CHECK(nmea_parse_time_ms(fld("141320.25"), &ms));
+    CHECK_EQ(ms, ((14 * 60 + 13) * 60 + 20) * 1000 + 250);
+    CHECK(nmea_parse_time_ms(fld("235960"), &ms));   // leap second
+    CHECK_EQ(ms, 86400000);
+    CHECK(!nmea_parse_time_ms(fld("240000"), &ms));
+    CHECK(!nmea_parse_time_ms(fld("1413"), &ms));
+    CHECK(!nmea_parse_time_ms(fld("14132x.00"), &ms));
+
+    int32_t y = 0, m = 0, d = 0;
+    CHECK(nmea_parse_ddmmyy(fld("210926"), &y, &m, &d));
+    CHECK_EQ(y, 2026);
+    CHECK_EQ(m, 9);
+    CHECK_EQ(d, 21);
+    CHECK(!nmea_parse_ddmmyy(fld("211326"), &y, &m, &d));
+    CHECK(!nmea_parse_ddmmyy(fld("000926"), &y, &m, &d));
+    CHECK(!nmea_parse_ddmmyy(fld("2109260"), &y, &m, &d));
+}
+
+void parse_coord() {
+    int32_t u = 0;
+    CHECK(nmea_parse_coord(fld("4807.0380"), fld("N"), &u));
+    CHECK_EQ(u, 48117300);
+    CHECK(nmea_parse_coord(fld("01131.0000"), fld("W"), &u));
+    CHECK_EQ(u, -11516666);
+    CHECK(nmea_parse_coord(fld("3352.1234567"), fld("S"), &u));   // 7th place dropped
+    CHECK_EQ(u, -33868724);
+    CHECK(!nmea_parse_coord(fld("4807.0380"), fld(""), &u));
+    CHECK(!nmea_parse_coord(fld("4807.0380"), fld("X"), &u));
+    CHECK(!nmea_parse_coord(fld("4860.0000"), fld("N"), &u));
+}
+
+void corrupted_rmc_rejected() {
+    gps = GpsStatus{};
+    update_from_nmea(with_checksum("GNGGA,141320.000,4807.0380,N,01131.0000,E,1,09,0.86,545.4,M,46.9,M,,"));
+    CHECK_EQ(gps.nmea_ok, 1);
+    CHECK_EQ(gps.sats, 9);
+    CHECK_EQ(gps.hdop_centi, 86);
+
+    char line[128];
+    std::strcpy(line, with_checksum("GNRMC,141320.000,A,4807.0380,N,01131.0000,E,0.02,211.35,210926,,,A"));
+    line[7] = '2';
+    update_from_nmea(line);
+    CHECK_EQ(gps.nmea_rejected, 1);
+    CHECK(!gps.rmc_valid);
+    CHECK_EQ(gps.rmc_time_ms, -1);
+}
+
+// update_from_nmea() picks the parser from the raw "$ttTTT," address, any
+// talker, before tokenizing.
+void dispatch_by_type() {
+    gps = GpsStatus{};
+    update_from_nmea(with_checksum("GPGGA,141320.000,4807.0380,N,01131.0000,E,1,07,1.20,545.4,M,46.9,M,,"));
+    CHECK_EQ(gps.sats, 7);
+    update_from_nmea(with_checksum("BDGGA,141321.000,4807.0380,N,01131.0000,E,1,11,0.90,545.4,M,46.9,M,,"));
+    CHECK_EQ(gps.sats, 11);
+    update_from_nmea(with_checksum("GLRMC,141322.000,A,4807.0380,N,01131.0000,E,0.02,211.35,210926,,,A"));
+    CHECK_EQ(gps.rmc_time_ms, 51202000);
+    CHECK(gps.rmc_valid);
+    update_from_nmea(with_checksum("GNZDA,141323.00,21,09,2026,00,00"));
+    CHECK_EQ(gps.zda_time_ms, 51203000);
+    CHECK_EQ(gps.nmea_ok, 4);
+
+    // Not one of ours: wrong type, no talker, truncated or empty address.
+    update_from_nmea(with_checksum("GPRMB,A,0.66,L,003,004,4917.24,N,12309.57,W,001.3,052.5,000.5,V"));
+    update_from_nmea(with_checksum("RMC,141324.000,A"));
+    update_from_nmea(with_checksum("GPRM,141324.000,A"));
+    update_from_nmea(with_checksum("GPGG"));
+    update_from_nmea("$G");
+    update_from_nmea("$");
+    CHECK_EQ(gps.nmea_ok, 4);
+    CHECK_EQ(gps.nmea_rejected, 0);
+    CHECK_EQ(gps.rmc_time_ms, 51202000);
+}
+
+void unused_types_skipped() {
+    gps = GpsStatus{};
+    update_from_nmea(with_checksum("GPGSV,3,3,12,10,05,030,,12,03,330,,25,02,170,,32,01,210,"));
+    update_from_nmea("$GPGSV,3,3,12*00");           // bad checksum, never walked
+    update_from_nmea(with_checksum("GNRMCX,141320.000,A"));
+    CHECK_EQ(gps.nmea_ok, 0);
+    CHECK_EQ(gps.nmea_rejected, 0);
+}
+
+} // namespace
+
+extern const TestCase k_nmea_tests[] = {
+    {"fields_split",           fields_split},
+    {"line_endings_ignored",   line_endings_ignored},
+    {"checksum_checked",       checksum_checked},
+    {"not_nmea",               not_nmea},
+    {"too_many_fields",        too_many_fields},
+    {"parse_u32",              parse_u32},
+    {"parse_fixed",            parse_fixed},
+    {"parse_time_date",        parse_time_date},
+    {"parse_coord",            parse_coord},
+    {"corrupted_rmc_rejected", corrupted_rmc_rejected},
+    {"dispatch_by_type",       dispatch_by_type},
+    {"unused_types_skipped",   unused_types_skipped},
+    {nullptr, nullptr},
+};
@@ -0,0 +1,112 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+// Reply and KoD construction (ntp_packet.cpp).
+
+#include "test.h"
+#include "ntp_packet.h"
+
+#include <cstring>
+
+namespace {
+
+NtpPacket make_request(uint8_t vn) {
+    NtpPacket p;
+    std::memset(&p, 0, sizeof(p));
+    p.li_vn_mode = ntp_make_li_vn_mode(0, vn, 3);
+    p.poll       = 6;
+    p.recv_ts_s  = hton32(0xEE5A0001u);
+    p.recv_ts_f  = hton32(0x11111111u);
+    p.tx_ts_s    = hton32(0xEE5A1234u);
+    p.tx_ts_f    = hton32(0x80000000u);
+    return p;
+}
+
+void reply_in_place() {
+    NtpPacket p = make_request(4);
+    const NtpPacket req = p;
+    ntp_fill_response(&p, &p, 0xEE5A2000u, 0x1000u, 0xEE5A2000u, 0x2000u, false);
+
+    CHECK_EQ(p.li_vn_mode & 0x07, 4);                // server
+    CHECK_EQ(ntp_extract_vn(p.li_vn_mode), 4);
+    CHECK_EQ(p.li_vn_mode >> 6, 3);                   // no timebase yet: unsynchronized
+    CHECK_EQ(p.poll, 6);
+    CHECK_EQ(p.ref_id, hton32(NTP_REFID_GPS));
+    CHECK_EQ(p.orig_ts_s, req.tx_ts_s);               // echoed verbatim
+    CHECK_EQ(p.orig_ts_f, req.tx_ts_f);
+    CHECK_EQ(p.recv_ts_s, hton32(0xEE5A2000u));
+    CHECK_EQ(p.recv_ts_f, hton32(0x1000u));
+    CHECK_EQ(p.tx_ts_f,   hton32(0x2000u));
+}
+
+void reply_interleaved_origin() {
+    NtpPacket p = make_request(4);
+    const NtpPacket req = p;
+    ntp_fill_response(&p, &p, 1, 2, 3, 4, true);
+    CHECK_EQ(p.orig_ts_s, req.recv_ts_s);
+    CHECK_EQ(p.orig_ts_f, req.recv_ts_f);
+}
+
+void version_normalized() {
+    NtpPacket p = make_request(3);
+    ntp_fill_response(&p, &p, 1, 2, 3, 4, false);
+    CHECK_EQ(ntp_extract_vn(p.li_vn_mode), 3);
+
+    p = make_request(1);
+    ntp_fill_response(&p, &p, 1, 2, 3, 4, false);
+    CHECK_EQ(ntp_extract_vn(p.li_vn_mode), 4);
+}
+
+void kod_rate() {
+    NtpPacket p = make_request(4);
+    const NtpPacket req = p;
+    ntp_fill_kod(&p, NTP_KOD_RATE);
+
+    CHECK_EQ(p.li_vn_mode >> 6, 3);
+    CHECK_EQ(p.li_vn_mode & 0x07, 4);
+    CHECK_EQ(p.stratum, 0);
+    CHECK_EQ(p.ref_id, hton32(NTP_KOD_RATE));
+    CHECK_EQ(p.orig_ts_s, req.tx_ts_s);
+    CHECK_EQ(p.recv_ts_s, req.tx_ts_s);
+    CHECK_EQ(p.tx_ts_f,   req.tx_ts_f);
+}
+
+void interleaved_request_detection() {
+    ClientEntry ce;
+    NtpPacket p = make_request(4);
+    CHECK(!ntp_is_interleaved_request(&p, nullptr));
+    CHECK(!ntp_is_interleaved_request(&p, &ce));      // no previous reply
+
+    ce.rx_ts_s = 0xEE5A3000u;
+    ce.rx_ts_f = 0x3000u;
+    ce.tx_ts_s = 0xEE5A3000u;
+    ce.tx_ts_f = 0x4000u;
+    p.orig_ts_s = hton32(ce.rx_ts_s);
+    p.orig_ts_f = hton32(ce.rx_ts_f);
+    CHECK(ntp_is_interleaved_request(&p, &ce));
+
+    // Basic-mode clients send rx == tx
+    p.recv_ts_s = p.tx_ts_s;
+    p.recv_ts_f = p.tx_ts_f;
+    CHECK(!ntp_is_interleaved_request(&p, &ce));
+}
+
+} // namespace
+
+extern const TestCase k_packet_tests[] = {
+    {"reply_in_place",                reply_in_place},
+    {"reply_interleaved_origin",      reply_interleaved_origin},
+    {"version_normalized",            version_normalized},
+    {"kod_rate",                      kod_rate},
+    {"interleaved_request_detection", interleaved_request_detection},
+    {nullptr, nullptr},
+};
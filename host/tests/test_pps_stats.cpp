@@ -0,0 +1,217 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+// PPS edge classification (pps_stats): edges go in through the capture
+// IRQ on virtual time, and each verdict decides whether the servo sees it.
+
+#include "test.h"
+#include "host_hal.h"
+#include "pps.h"
+#include "pps_stats.h"
+
+#include "hardware/gpio.h"
+
+namespace {
+
+constexpr uint32_t PPS_GPIO = 16;
+constexpr uint64_t SEC_US   = 1000000;
+
+// Small repeating jitter, so the MAD is 1 us (tolerance ~9 us).
+constexpr int32_t JITTER_US[] = {0, 1, -1, 0, 2, -1, 1, 0};
+
+uint64_t g_t0_us = 0;   // second 0 of the current test
+
+void start() {
+    static bool inited = false;
+    if (!inited) pps_init(PPS_GPIO);
+    inited = true;
+    g_t0_us = (host_time_us() / SEC_US + 10u) * SEC_US;
+    pps_stats_init();
+}
+
+// Capture an edge at t0 + us and classify it.
+PpsVerdict edge_at(uint64_t us) {
+    host_time_set_us(g_t0_us + us);
+    host_gpio_edge(PPS_GPIO, GPIO_IRQ_EDGE_RISE);
+    pps_stats_service();
+    return pps_stats_verdict(pps_get_edges());
+}
+
+// Edges on seconds [from, to), with the jitter pattern; true if all accepted.
+bool train(uint32_t from, uint32_t to, int64_t offset_us = 0) {
+    bool ok = true;
+    for (uint32_t s = from; s < to; ++s) {
+        const int64_t us = static_cast<int64_t>(s * SEC_US) + offset_us + JITTER_US[s % 8];
+        ok = (edge_at(static_cast<uint64_t>(us)) == PpsVerdict::Accepted) && ok;
+    }
+    return ok;
+}
+
+PpsStats stats() {
+    PpsStats st;
+    CHECK(pps_stats_get(&st));
+    return st;
+}
+
+void trains_filter() {
+    start();
+    CHECK(train(0, 8));
+    CHECK(!stats().filter_ready);       // 7 intervals so far
+    CHECK(train(8, 20));
+
+    const PpsStats st = stats();
+    CHECK(st.filter_ready);
+    CHECK_EQ(st.edges, 20);
+    CHECK_EQ(st.accepted, 20);
+    CHECK_EQ(st.long_win.n, 19);
+    CHECK_EQ(st.short_win.n, 16);
+    CHECK_EQ(st.mad_ns, 1000);
+    CHECK_EQ(st.tol_ns, 8898);          // 6 * 1.483 * MAD
+    CHECK(st.median_ns >= -1000 && st.median_ns <= 1000);
+    CHECK_EQ(st.outliers + st.extra + st.missing + st.resyncs, 0);
+    CHECK(pps_stats_healthy(host_time_us(), SEC_US));
+    CHECK(!pps_stats_healthy(host_time_us() + 3 * SEC_US, 2 * SEC_US));
+}
+
+void glitch_is_extra() {
+    start();
+    CHECK(train(0, 20));
+
+    // A pulse 400 ms into the second is a different pulse. The reference
+    // stays on the last real edge, so the next one is a clean 1 s interval.
+    CHECK(edge_at(19 * SEC_US + 400000) == PpsVerdict::Extra);
+    CHECK(edge_at(20 * SEC_US) == PpsVerdict::Accepted);
+    // Too close behind an accepted edge to be the next second, too.
+    CHECK(edge_at(20 * SEC_US + 20) == PpsVerdict::Extra);
+    CHECK(train(21, 24));
+
+    const PpsStats st = stats();
+    CHECK_EQ(st.extra, 2);
+    CHECK_EQ(st.missing, 0);
+    CHECK_EQ(st.outliers, 0);
+    CHECK_EQ(st.long_win.n, 23);
+    CHECK(st.last_accepted);
+}
+
+void dropped_pulse_counted() {
+    start();
+    CHECK(train(0, 20));
+
+    // Second 20 never arrives: 21 is accepted across the 2 s gap, counted
+    // as one missing pulse, and adds no interval sample.
+    CHECK(edge_at(21 * SEC_US + 1) == PpsVerdict::Accepted);
+    PpsStats st = stats();
+    CHECK_EQ(st.missing, 1);
+    CHECK_EQ(st.long_win.n, 19);
+
+    // Three in a row missing.
+    CHECK(edge_at(25 * SEC_US) == PpsVerdict::Accepted);
+    st = stats();
+    CHECK_EQ(st.missing, 4);
+    CHECK_EQ(st.outliers, 0);
+    CHECK(train(26, 28));
+    CHECK_EQ(stats().long_win.n, 21);
+}
+
+void outlier_rejected() {
+    start();
+    CHECK(train(0, 20));
+
+    // On the grid but 40 us late: well past the ~9 us tolerance.
+    CHECK(edge_at(20 * SEC_US + 40) == PpsVerdict::Outlier);
+    PpsStats st = stats();
+    CHECK_EQ(st.outliers, 1);
+    CHECK(!st.last_accepted);
+    CHECK(!pps_stats_healthy(host_time_us(), 2 * SEC_US));
+
+    // The next good edge is judged against the last accepted one (2 s back).
+    CHECK(edge_at(21 * SEC_US) == PpsVerdict::Accepted);
+    st = stats();
+    CHECK(st.last_accepted);
+    CHECK_EQ(st.resyncs, 0);
+    CHECK_EQ(st.long_win.n, 19);
+
+    // Just inside the tolerance is fine.
+    CHECK(edge_at(22 * SEC_US + 8) == PpsVerdict::Accepted);
+}
+
+void step_resyncs() {
+    start();
+    CHECK(train(0, 20));
+
+    // The pulse train moves 200 us later for good (receiver re-lock).
+    // RESYNC_RUN (4) on-grid rejections in a row restart the filter from
+    // the newest edge, which is then accepted.
+    const int64_t STEP_US = 200;
+    for (uint32_t s = 20; s < 23; ++s) {
+        CHECK(edge_at(s * SEC_US + STEP_US) == PpsVerdict::Outlier);
+    }
+    CHECK(edge_at(23 * SEC_US + STEP_US) == PpsVerdict::Accepted);
+
+    PpsStats st = stats();
+    CHECK_EQ(st.outliers, 4);
+    CHECK_EQ(st.resyncs, 1);
+    CHECK(!st.filter_ready);
+    CHECK_EQ(st.long_win.n, 0);
+
+    // Retrains on the new grid.
+    CHECK(train(24, 40, STEP_US));
+    st = stats();
+    CHECK(st.filter_ready);
+    CHECK_EQ(st.resyncs, 1);
+    CHECK_EQ(st.long_win.n, 16);
+    CHECK(st.median_ns >= -1000 && st.median_ns <= 1000);
+}
+
+void boot_tolerance() {
+    start();
+    // Untrained: anything within 1000 ppm of the grid is accepted...
+    CHECK(edge_at(0) == PpsVerdict::Accepted);
+    CHECK(edge_at(SEC_US + 900) == PpsVerdict::Accepted);
+    CHECK(edge_at(2 * SEC_US + 900 + 600) == PpsVerdict::Accepted);
+    // ...and beyond it is an outlier, but still on the grid.
+    CHECK(edge_at(3 * SEC_US + 1500 + 1200) == PpsVerdict::Outlier);
+    CHECK_EQ(stats().outliers, 1);
+}
+
+void ring_overrun_restarts() {
+    start();
+    CHECK(train(0, 20));
+
+    // More edges than the ring holds go by unclassified: they are lost,
+    // not missing, and the reference restarts from what is left.
+    for (uint32_t s = 20; s < 20 + PPS_HISTORY + 5; ++s) {
+        host_time_set_us(g_t0_us + s * SEC_US);
+        host_gpio_edge(PPS_GPIO, GPIO_IRQ_EDGE_RISE);
+    }
+    pps_stats_service();
+
+    const PpsStats st = stats();
+    CHECK_EQ(st.lost, 5);
+    CHECK_EQ(st.missing, 0);
+    CHECK_EQ(st.accepted, 20 + PPS_HISTORY);
+    CHECK(pps_stats_verdict(pps_get_edges()) == PpsVerdict::Accepted);
+    CHECK(pps_stats_verdict(pps_get_edges() - PPS_HISTORY) == PpsVerdict::Unknown);
+}
+
+} // namespace
+
+extern const TestCase k_pps_stats_tests[] = {
+    {"trains_filter",         trains_filter},
+    {"glitch_is_extra",       glitch_is_extra},
+    {"dropped_pulse_counted", dropped_pulse_counted},
+    {"outlier_rejected",      outlier_rejected},
+    {"step_resyncs",          step_resyncs},
+    {"boot_tolerance",        boot_tolerance},
+    {"ring_overrun_restarts", ring_overrun_restarts},
+    {nullptr, nullptr},
+};
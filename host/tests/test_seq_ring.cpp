@@ -0,0 +1,128 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+// SeqRing (seq_ring.h) with a producer thread running flat out against
+// concurrent readers: every copy a reader accepts must be one whole record,
+// the one it asked for, and the newest-record sequence never goes back.
+
+#include "test.h"
+#include "seq_ring.h"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+
+// ~0.5 KB, so a reader's copy is long enough for the producer to overwrite
+// the slot part-way through.
+struct Rec {
+    uint32_t seq = 0;
+    uint32_t pad = 0;
+    uint64_t w[64]{};
+};
+
+Rec make(uint32_t seq) {
+    Rec r;
+    r.seq = seq;
+    r.pad = ~seq;
+    for (uint32_t i = 0; i < 64; ++i) r.w[i] = (static_cast<uint64_t>(seq) << 32) * (i + 1) + seq;
+    return r;
+}
+
+bool whole(const Rec& r) {
+    if (r.pad != ~r.seq) return false;
+    for (uint32_t i = 0; i < 64; ++i) {
+        if (r.w[i] != (static_cast<uint64_t>(r.seq) << 32) * (i + 1) + r.seq) return false;
+    }
+    return true;
+}
+
+constexpr uint32_t N = 16;
+
+void sequential() {
+    SeqRing<Rec, N> ring;
+    Rec r;
+    CHECK_EQ(ring.head(), 0);
+    CHECK(!ring.read(0, &r));
+    CHECK(!ring.read(1, &r));
+    CHECK(!ring.read_latest(&r, nullptr));
+
+    for (uint32_t s = 1; s <= 40; ++s) CHECK_EQ(ring.push(make(s)), s);
+    CHECK_EQ(ring.head(), 40);
+
+    uint32_t seq = 0;
+    CHECK(ring.read_latest(&r, &seq));
+    CHECK_EQ(seq, 40);
+    CHECK_EQ(r.seq, 40);
+
+    // The last N are readable, anything older is gone, nothing newer exists.
+    for (uint32_t s = 40 - N + 1; s <= 40; ++s) {
+        CHECK(ring.read(s, &r));
+        CHECK_EQ(r.seq, s);
+    }
+    CHECK(!ring.read(40 - N, &r));
+    CHECK(!ring.read(41, &r));
+}
+
+void concurrent_producer() {
+    constexpr uint32_t RECORDS = 2000000;
+    static SeqRing<Rec, N> ring;
+
+    std::atomic<bool> done{false};
+    std::atomic<uint32_t> torn{0}, wrong{0}, regress{0}, reads{0}, misses{0};
+
+    auto reader = [&](bool by_seq) {
+        uint32_t last = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            Rec r;
+            uint32_t seq = 0;
+            if (by_seq) {
+                // Chase the oldest record still in the ring: the one most
+                // likely to be overwritten mid-copy.
+                const uint32_t head = ring.head();
+                if (head < N) continue;
+                seq = head - N + 1;
+                if (!ring.read(seq, &r)) { misses++; continue; }
+            } else {
+                if (!ring.read_latest(&r, &seq)) { misses++; continue; }
+                if (seq < last) regress++;
+                last = seq;
+            }
+            reads++;
+            if (!whole(r)) torn++;
+            else if (r.seq != seq) wrong++;
+        }
+    };
+
+    std::thread t1(reader, false), t2(reader, true), t3(reader, true);
+    for (uint32_t s = 1; s <= RECORDS; ++s) ring.push(make(s));
+    done.store(true, std::memory_order_release);
+    t1.join();
+    t2.join();
+    t3.join();
+
+    std::printf("  %u records, %u clean reads, %u refused\n",
+                RECORDS, reads.load(), misses.load());
+    CHECK_EQ(torn.load(), 0);
+    CHECK_EQ(wrong.load(), 0);
+    CHECK_EQ(regress.load(), 0);
+    CHECK(reads.load() > 0);
+    CHECK_EQ(ring.head(), RECORDS);
+}
+
+} // namespace
+
+extern const TestCase k_seq_ring_tests[] = {
+    {"sequential",          sequential},
+    {"concurrent_producer", concurrent_producer},
+    {nullptr, nullptr},
+};
@@ -0,0 +1,175 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+// Servo discipline against synthetic PPS edge streams: a local 1 MHz
+// counter with a frequency offset and Gaussian edge jitter, captured at
+// whole microseconds like the GPIO IRQ path.
+
+#include "test.h"
+#include "servo.h"
+#include "int_math.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr uint64_t UNIX0 = 1760000000ULL;
+
+// Deterministic Gaussian noise (xorshift64 + Box-Muller).
+struct Rng {
+    uint64_t s = 0x9E3779B97F4A7C15ULL;
+
+    double uniform() {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return (static_cast<double>(s >> 11) + 0.5) / 9007199254740992.0;
+    }
+    double gauss() {
+        return std::sqrt(-2.0 * std::log(uniform())) * std::cos(6.283185307179586 * uniform());
+    }
+};
+
+// True seconds since UNIX0 -> local counter. Boot is not second-aligned.
+struct Oscillator {
+    double ppm = 0;
+    double boot_ns = 5.123456e9;
+
+    double local_ns(double t_s) const { return boot_ns + t_s * 1e9 * (1.0 + ppm * 1e-6); }
+    uint64_t local_us(double t_s) const { return static_cast<uint64_t>(local_ns(t_s) / 1000.0); }
+};
+
+struct Run {
+    Servo      servo{};
+    Oscillator osc{};
+    Rng        rng{};
+    double     jitter_ns = 0;
+
+    bool edge(uint64_t n, double extra_ns = 0) {
+        const double t = static_cast<double>(n) + (jitter_ns * rng.gauss() + extra_ns) * 1e-9;
+        return servo_on_edge(&servo, osc.local_us(t), 0, UNIX0 + n);
+    }
+
+    // Model error against true time half-way through second n, in ns.
+    int64_t error_at(uint64_t n) const {
+        const double t = static_cast<double>(n) + 0.5;
+        const uint64_t lus = osc.local_us(t);
+        uint64_t s = 0;
+        uint32_t ns = 0;
+        servo_model_eval(&servo.model, lus, &s, &ns);
+        // lus was floored, so the true time of that tick is slightly earlier
+        const double tick_t = t - (osc.local_ns(t) - lus * 1000.0) * 1e-9 / (1.0 + osc.ppm * 1e-6);
+        const double err = (static_cast<double>(s - UNIX0) - tick_t) * 1e9 + ns;
+        return static_cast<int64_t>(std::llround(err));
+    }
+};
+
+// Offset + jitter: FLL for 8 s, then the PLL locks and holds the phase.
+void lock_with_offset(double ppm, double jitter_ns) {
+    Run r;
+    r.osc.ppm = ppm;
+    r.jitter_ns = jitter_ns;
+    servo_init(&r.servo);
+
+    CHECK(r.edge(0));
+    CHECK(r.servo.state == ServoState::Fll);
+
+    uint64_t n = 1;
+    for (; n < 8; ++n) r.edge(n);
+    CHECK(r.servo.state == ServoState::Fll);
+    r.edge(n++);
+    CHECK(r.servo.state == ServoState::Pll);
+
+    uint64_t locked_at = 0;
+    for (; n < 60; ++n) {
+        r.edge(n);
+        if (!locked_at && servo_is_locked(&r.servo)) locked_at = n;
+    }
+    CHECK(locked_at != 0 && locked_at < 40);
+
+    // Steady state: no more steps, every edge in the lock window and the
+    // served time within a few us of true time between edges.
+    int64_t max_edge = 0, max_mid = 0;
+    for (; n < 600; ++n) {
+        CHECK(r.edge(n));
+        max_edge = std::max(max_edge, abs64(r.servo.last_offset_ns));
+        max_mid  = std::max(max_mid,  abs64(r.error_at(n)));
+        if (!servo_is_locked(&r.servo)) { CHECK(servo_is_locked(&r.servo)); break; }
+    }
+    CHECK_EQ(r.servo.steps, 1);
+    CHECK(max_edge <= 2000 + static_cast<int64_t>(6 * jitter_ns));
+    CHECK(max_mid  <= 3000 + static_cast<int64_t>(6 * jitter_ns));
+
+    // Learned correction: (true - local) / local
+    const double want_ppb = -ppm * 1e3 / (1.0 + ppm * 1e-6);
+    CHECK(std::fabs(servo_freq_ppb(&r.servo) - want_ppb) <= 100.0);
+}
+
+void lock_fast_oscillator() { lock_with_offset(+73.0, 300.0); }
+void lock_slow_oscillator() { lock_with_offset(-212.5, 300.0); }
+void lock_noisy_edges()     { lock_with_offset(+20.0, 2000.0); }
+
+Run locked_run() {
+    Run r;
+    r.osc.ppm = 40.0;
+    r.jitter_ns = 200.0;
+    servo_init(&r.servo);
+    for (uint64_t n = 0; n < 60; ++n) r.edge(n);
+    return r;
+}
+
+// A single edge far off the grid is ignored without stepping.
+void outlier_rejected() {
+    Run r = locked_run();
+    CHECK(servo_is_locked(&r.servo));
+
+    CHECK(!r.edge(60, 50e6));                  // 50 ms late
+    CHECK(r.servo.state == ServoState::Pll);
+    CHECK_EQ(r.servo.steps, 1);
+    CHECK(r.edge(61));
+    CHECK(abs64(r.servo.last_offset_ns) < 5000);
+}
+
+// Several in a row mean the model is wrong: start over from the new edges.
+void persistent_offset_steps() {
+    Run r = locked_run();
+    uint64_t n = 60;
+    for (int i = 0; i < 3; ++i) r.edge(n++, 20e6);
+    CHECK(r.servo.state == ServoState::Fll);
+    CHECK_EQ(r.servo.steps, 2);
+
+    for (; n < 140; ++n) r.edge(n, 20e6);
+    CHECK(servo_is_locked(&r.servo));
+    CHECK(abs64(r.servo.last_offset_ns) < 5000);
+}
+
+// A missing second is bridged: the next edge is measured over 2 s.
+void missing_edge_bridged() {
+    Run r = locked_run();
+    CHECK(r.edge(61));                          // 60 never arrives
+    CHECK(r.servo.state == ServoState::Pll);
+    CHECK(abs64(r.servo.last_offset_ns) < 5000);
+    CHECK(!r.edge(61));                         // same second again
+}
+
+} // namespace
+
+extern const TestCase k_servo_tests[] = {
+    {"lock_fast_oscillator",    lock_fast_oscillator},
+    {"lock_slow_oscillator",    lock_slow_oscillator},
+    {"lock_noisy_edges",        lock_noisy_edges},
+    {"outlier_rejected",        outlier_rejected},
+    {"persistent_offset_steps", persistent_offset_steps},
+    {"missing_edge_bridged",    missing_edge_bridged},
+    {nullptr, nullptr},
+};
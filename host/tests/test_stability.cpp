@@ -0,0 +1,162 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+// stability_add(): the incremental ADEV/MDEV/TDEV against a direct
+// evaluation of the fully overlapping estimators over the same phase
+// record, including the sums carrying on across a gap.
+
+#include "test.h"
+#include "stability.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Ref {
+    double   sum_d2 = 0.0, sum_s2 = 0.0;
+    uint32_t n_d = 0, n_s = 0;
+};
+
+// Add one contiguous run of phase samples to the reference sums for tau = m.
+void ref_add_run(const std::vector<int64_t>& x, uint32_t m, Ref* r) {
+    const size_t n = x.size();
+    std::vector<double> d;
+    for (size_t i = 0; i + 2 * m < n; ++i) {
+        d.push_back(static_cast<double>(x[i + 2 * m] - 2 * x[i + m] + x[i]));
+        r->sum_d2 += d.back() * d.back();
+        r->n_d++;
+    }
+    for (size_t i = 0; i + m <= d.size(); ++i) {
+        double s = 0.0;
+        for (size_t j = i; j < i + m; ++j) s += d[j];
+        r->sum_s2 += s * s;
+        r->n_s++;
+    }
+}
+
+bool close(double got, double want) {
+    return std::fabs(got - want) <= 1e-5 * std::fabs(want) + 1e-15;
+}
+
+// Feed the runs (each starting gap_s after the previous one ended) and
+// compare every tau with the reference.
+void check_runs(const std::vector<std::vector<int64_t>>& runs, uint32_t gap_s) {
+    stability_reset();
+    uint64_t t = 1790000000ULL;
+    for (size_t k = 0; k < runs.size(); ++k) {
+        if (k) t += gap_s;
+        for (int64_t x : runs[k]) stability_add(t++, x);
+    }
+
+    StabilityReport rep;
+    CHECK(stability_get(&rep));
+    uint32_t total = 0;
+    for (const auto& r : runs) total += static_cast<uint32_t>(r.size());
+    CHECK_EQ(rep.samples, total);
+    CHECK_EQ(rep.gaps, runs.size() - 1);
+    CHECK_EQ(rep.run_s, runs.back().size());
+
+    for (uint32_t i = 0; i < STABILITY_TAUS; ++i) {
+        const uint32_t m = 1u << i;
+        Ref ref;
+        for (const auto& r : runs) ref_add_run(r, m, &ref);
+
+        const StabilityPoint& p = rep.pt[i];
+        CHECK_EQ(p.tau_s, m);
+        CHECK_EQ(p.n_adev, ref.n_d);
+        CHECK_EQ(p.n_mdev, ref.n_s);
+        const double adev = ref.n_d ? std::sqrt(ref.sum_d2 / (2.0 * ref.n_d)) / m * 1e-9 : 0.0;
+        const double rms  = ref.n_s ? std::sqrt(ref.sum_s2 / (2.0 * ref.n_s)) : 0.0;
+        const double mdev = rms / (1.0 * m * m) * 1e-9;
+        const double tdev = rms / (m * std::sqrt(3.0));
+        if (!close(p.adev, adev) || !close(p.mdev, mdev) || !close(p.tdev_ns, tdev)) {
+            std::printf("  tau %u: adev %g/%g mdev %g/%g tdev %g/%g\n", m,
+                        p.adev, adev, p.mdev, mdev, p.tdev_ns, tdev);
+            CHECK(false);
+        }
+    }
+}
+
+std::vector<int64_t> white_pm(uint32_t n, double sigma_ns, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> g(0.0, sigma_ns);
+    std::vector<int64_t> x(n);
+    for (int64_t& v : x) v = std::lround(g(rng));
+    return x;
+}
+
+void white_phase_matches_reference() {
+    check_runs({ white_pm(3000, 20.0, 1) }, 0);
+
+    // White PM: MDEV falls as tau^-1.5, ADEV only as tau^-1.
+    StabilityReport rep;
+    CHECK(stability_get(&rep));
+    CHECK(rep.pt[0].mdev > 0.0f);
+    CHECK(rep.pt[4].adev / rep.pt[0].adev < 0.1f);
+    CHECK(rep.pt[4].mdev / rep.pt[0].mdev < 0.03f);
+}
+
+void gap_restarts_differences() {
+    // Three runs: one long enough for every tau, one too short for the
+    // long ones, one in between. No difference may straddle a gap.
+    check_runs({ white_pm(2000, 20.0, 2), white_pm(40, 20.0, 3), white_pm(700, 5.0, 4) }, 5);
+}
+
+void frequency_offset_and_drift() {
+    // A constant frequency offset is a phase ramp: every second difference
+    // is zero.
+    std::vector<int64_t> ramp(1600);
+    for (size_t i = 0; i < ramp.size(); ++i) ramp[i] = 5 * static_cast<int64_t>(i) - 3000;
+    check_runs({ ramp }, 0);
+    StabilityReport rep;
+    CHECK(stability_get(&rep));
+    for (const StabilityPoint& p : rep.pt) {
+        CHECK(p.adev == 0.0f);
+        CHECK(p.mdev == 0.0f);
+    }
+
+    // Linear drift x = a t^2: ADEV = MDEV = sqrt(2) a tau, a = 1 ns/s^2.
+    std::vector<int64_t> quad(1600);
+    for (size_t i = 0; i < quad.size(); ++i) quad[i] = static_cast<int64_t>(i * i);
+    check_runs({ quad }, 0);
+    CHECK(stability_get(&rep));
+    for (const StabilityPoint& p : rep.pt) {
+        if (!p.n_mdev) continue;
+        const double want = std::sqrt(2.0) * p.tau_s * 1e-9;
+        CHECK(close(p.adev, want));
+        CHECK(close(p.mdev, want));
+    }
+}
+
+void out_of_order_ignored() {
+    stability_reset();
+    for (uint64_t t = 100; t < 110; ++t) stability_add(t, 7);
+    stability_add(109, 1000000);
+    stability_add(50, 1000000);
+    StabilityReport rep;
+    CHECK(stability_get(&rep));
+    CHECK_EQ(rep.samples, 10);
+    CHECK_EQ(rep.gaps, 0);
+    CHECK(rep.pt[0].adev == 0.0f);
+}
+
+} // namespace
+
+extern const TestCase k_stability_tests[] = {
+    {"white_phase_matches_reference", white_phase_matches_reference},
+    {"gap_restarts_differences",      gap_restarts_differences},
+    {"frequency_offset_and_drift",    frequency_offset_and_drift},
+    {"out_of_order_ignored",          out_of_order_ignored},
+    {nullptr, nullptr},
+};
@@ -0,0 +1,164 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+// Tempco fit (tempco.h): samples at 1 C bin centres from a known curve,
+// then the fit order, the prediction and its clamping outside the range.
+
+#include "test.h"
+#include "tempco.h"
+
+#include <cmath>
+
+namespace {
+
+constexpr int BIN_MIN_N = 4;   // samples a bin needs to count
+
+// Quadratic reference curve, ppb at T (C).
+double curve(double t_c) {
+    const double x = t_c - 30.0;
+    return 50.0 - 30.0 * x + 4.0 * x * x;
+}
+
+// BIN_MIN_N samples at the centre of each bin lo_c .. hi_c.
+void fill(Tempco* tc, int lo_c, int hi_c, double (*f)(double)) {
+    for (int t = lo_c; t <= hi_c; ++t) {
+        const double c = t + 0.5;
+        for (int i = 0; i < BIN_MIN_N; ++i) {
+            tempco_add(tc, static_cast<int32_t>(c * 1000.0), static_cast<int32_t>(std::lround(f(c))));
+        }
+    }
+}
+
+bool near(float a, double b, double tol) { return std::fabs(a - b) <= tol; }
+
+float predict(const Tempco& tc, double t_c) {
+    float ppb = NAN;
+    CHECK(tempco_predict(&tc, static_cast<int32_t>(std::lround(t_c * 1000.0)), &ppb));
+    return ppb;
+}
+
+void no_fit_until_span() {
+    Tempco tc;
+    tempco_init(&tc);
+    float ppb = 0.0f;
+    CHECK(!tempco_predict(&tc, 25000, &ppb));
+
+    // Under BIN_MIN_N samples a bin doesn't count.
+    for (int i = 0; i < BIN_MIN_N - 1; ++i) tempco_add(&tc, 25500, 100);
+    CHECK_EQ(tc.bins_used, 0);
+    tempco_add(&tc, 25500, 100);
+    CHECK_EQ(tc.bins_used, 1);
+
+    // Two bins 1 C apart: a slope over that span would be noise.
+    fill(&tc, 26, 26, curve);
+    CHECK_EQ(tc.bins_used, 2);
+    CHECK_EQ(tc.order, 0);
+    CHECK(!tempco_predict(&tc, 25000, &ppb));
+
+    // Outside -20 .. +80 C nothing is stored.
+    const uint32_t n = tc.samples;
+    tempco_add(&tc, -20001, 0);
+    tempco_add(&tc, 80000, 0);
+    CHECK_EQ(tc.samples, n);
+}
+
+void linear_fit() {
+    Tempco tc;
+    tempco_init(&tc);
+    // 2 .. 5 C of span: linear only, however curved the data.
+    fill(&tc, 20, 22, [](double t) { return 100.0 + 20.0 * (t - 25.0); });
+    CHECK_EQ(tc.order, 1);
+    CHECK(near(tc.c1, 20.0, 0.01));
+    CHECK(near(predict(tc, 21.0), 20.0, 0.1));
+    CHECK(near(predict(tc, 22.5), 50.0, 0.1));
+
+    Tempco q;
+    tempco_init(&q);
+    fill(&q, 28, 32, curve);   // 4 C span
+    CHECK_EQ(q.order, 1);
+}
+
+void quadratic_fit() {
+    Tempco tc;
+    tempco_init(&tc);
+    fill(&tc, 20, 40, curve);
+    CHECK_EQ(tc.order, 2);
+    CHECK_EQ(tc.bins_used, 21);
+    CHECK(near(tc.c2, 4.0, 0.01));
+
+    // Anywhere inside the sampled range, to within sample rounding.
+    for (double t = 20.5; t <= 40.5; t += 0.25) {
+        if (!near(predict(tc, t), curve(t), 0.6)) {
+            std::printf("  at %.2f C: %.2f vs %.2f ppb\n", t, predict(tc, t), curve(t));
+            CHECK(false);
+        }
+    }
+
+    // The residual still remembers new bins being predicted from the edge
+    // while the range grew; on exact data it settles to rounding level.
+    CHECK(tempco_resid_rms_ppb(&tc) > 1.0f);
+    for (int i = 0; i < 256; ++i) {
+        const double c = 20.5 + (i * 7) % 21;
+        tempco_add(&tc, static_cast<int32_t>(c * 1000.0), static_cast<int32_t>(std::lround(curve(c))));
+    }
+    CHECK(tempco_resid_rms_ppb(&tc) < 1.0f);
+}
+
+void prediction_clamped() {
+    Tempco tc;
+    tempco_init(&tc);
+    fill(&tc, 20, 40, curve);
+    CHECK(near(tc.t_lo, 20.5, 1e-6));
+    CHECK(near(tc.t_hi, 40.5, 1e-6));
+
+    // Beyond the sampled bins the edge value holds instead of the parabola.
+    const float lo = predict(tc, 5.0);
+    const float hi = predict(tc, 60.0);
+    CHECK(near(lo, predict(tc, 20.5), 0.01));
+    CHECK(near(hi, predict(tc, 40.5), 0.01));
+    CHECK(predict(tc, -19.0) == lo);
+    CHECK(predict(tc, 79.0) == hi);
+    CHECK(!near(predict(tc, 60.0), curve(60.0), 100.0));
+}
+
+void bins_average_and_age() {
+    Tempco tc;
+    tempco_init(&tc);
+
+    // A plain mean up to 64 samples...
+    for (int i = 0; i < 32; ++i) tempco_add(&tc, 25500, 100);
+    for (int i = 0; i < 32; ++i) tempco_add(&tc, 25500, 200);
+    const TempcoBin& b = tc.bins[25 - TEMPCO_MIN_C];
+    CHECK_EQ(b.n, 64);
+    CHECK(near(b.ppb, 150.0, 0.01));
+
+    // ...then an EMA that lets a new value take over.
+    for (int i = 0; i < 400; ++i) tempco_add(&tc, 25500, 300);
+    CHECK_EQ(b.n, 64);
+    CHECK(near(b.ppb, 300.0, 1.0));
+
+    // Negative temperatures land in the bin below zero, not the one above.
+    tempco_add(&tc, -500, 7);
+    CHECK_EQ(tc.bins[-1 - TEMPCO_MIN_C].n, 1);
+    CHECK_EQ(tc.bins[0 - TEMPCO_MIN_C].n, 0);
+}
+
+} // namespace
+
+extern const TestCase k_tempco_tests[] = {
+    {"no_fit_until_span",     no_fit_until_span},
+    {"linear_fit",            linear_fit},
+    {"quadratic_fit",         quadratic_fit},
+    {"prediction_clamped",    prediction_clamped},
+    {"bins_average_and_age",  bins_average_and_age},
+    {nullptr, nullptr},
+};
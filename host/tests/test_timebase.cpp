@@ -0,0 +1,172 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+// The timebase driven through the firmware's GPS path (gps_task_poll(), the
+// PPS IRQ and the UART ring) on virtual time with a perfect oscillator:
+// which PPS edge each RMC labels, and what replies advertise in holdover.
+
+#include "test.h"
+#include "host_hal.h"
+#include "gps_task.h"
+#include "timebase.h"
+
+#include "hardware/gpio.h"
+
+namespace {
+
+constexpr uint32_t PPS_GPIO  = 16;              // as wired in gps_task_init()
+constexpr uint64_t UTC_START = 1790000000ULL;   // 2026-09-21T14:13:20Z
+constexpr uint32_t STEP_MS   = 10;
+
+// One timeline for the whole suite, since virtual time and the PPS ring
+// keep running across tests; each test restarts the timebase 10 s after
+// the previous one ended.
+struct Sim {
+    uint64_t t0_us  = 0;   // local time of UTC_START
+    uint64_t now_ms = 0;   // since t0_us
+};
+
+Sim g_sim;
+
+void sim_start() {
+    if (g_sim.t0_us == 0) g_sim.t0_us = host_time_us();
+    g_sim.now_ms = (g_sim.now_ms / 1000u + 10u) * 1000u;
+    host_time_set_us(g_sim.t0_us + g_sim.now_ms * 1000u);
+    timebase_init();
+    gps_task_init();
+}
+
+uint64_t local_us(uint64_t ms) { return g_sim.t0_us + ms * 1000u; }
+
+void send_rmc(uint64_t utc_ms) {
+    const uint32_t ms  = static_cast<uint32_t>(utc_ms % 1000u);
+    const uint32_t sod = static_cast<uint32_t>((UTC_START + utc_ms / 1000u) % 86400u);
+    char body[96];
+    std::snprintf(body, sizeof(body),
+                  "GNRMC,%02u%02u%02u.%03u,A,4807.0380,N,01131.0000,E,0.02,211.35,210926,,,A",
+                  sod / 3600u, (sod / 60u) % 60u, sod % 60u, ms);
+    uint8_t sum = 0;
+    for (const char* p = body; *p; ++p) sum ^= static_cast<uint8_t>(*p);
+    char line[128];
+    const int len = std::snprintf(line, sizeof(line), "$%s*%02X\r\n", body, sum);
+    host_uart_rx(line, static_cast<size_t>(len));
+}
+
+// Run for `seconds`: a PPS edge on every whole second (if pps), an RMC per
+// 1000/rate_hz ms of UTC arriving latency_ms later (none if rate_hz is 0),
+// and the GPS loop polled every step_ms.
+void run(uint32_t seconds, uint32_t rate_hz, uint32_t latency_ms, bool pps,
+         uint32_t step_ms = STEP_MS) {
+    const uint64_t end_ms = g_sim.now_ms + seconds * 1000ull;
+    const uint32_t period = rate_hz ? 1000u / rate_hz : 0;
+    for (; g_sim.now_ms < end_ms; g_sim.now_ms += step_ms) {
+        const uint64_t t = g_sim.now_ms;
+        host_time_set_us(local_us(t));
+        if (pps && t % 1000u == 0) host_gpio_edge(PPS_GPIO, GPIO_IRQ_EDGE_RISE);
+        if (period && t >= latency_ms && (t - latency_ms) % period == 0) send_rmc(t - latency_ms);
+        gps_task_poll();
+    }
+}
+
+// Timebase error at local time ms (UTC_START + ms/1000 s is the truth).
+int64_t error_ns(uint64_t ms) {
+    uint64_t s = 0;
+    uint32_t ns = 0;
+    if (!timebase_local_to_unix(local_us(ms), &s, &ns)) return INT64_MAX;
+    const int64_t truth_ns = static_cast<int64_t>(ms) * 1000000;
+    return static_cast<int64_t>(s - UTC_START) * 1000000000 + ns - truth_ns;
+}
+
+void check_labels(uint32_t rate_hz, uint32_t latency_ms) {
+    sim_start();
+    run(30, rate_hz, latency_ms, true);
+
+    TimebaseStatus st;
+    timebase_get_status(&st);
+    CHECK(st.have_time);
+    CHECK(st.synced);
+    const int64_t err = error_ns(g_sim.now_ms);
+    if (err < -50000 || err > 50000) {
+        std::printf("  %u Hz, %u ms late: error %lld ns\n", rate_hz, latency_ms, (long long)err);
+        CHECK(false);
+    }
+}
+
+void rmc_1hz_labels_edge()            { check_labels(1, 150); }
+
+// At 10 Hz the N.900 sentence lands after edge N+1; only N+1.000 may
+// label it.
+void rmc_10hz_whole_second_labels()   { check_labels(10, 150); }
+
+// Locked, then the GPS goes away for 6 h. The advertised bound grows as
+// e0 + 50 ppb * t + 200 ppb/h * t^2 / 2, stratum 1 holds while it is
+// within 100 us, stratum 2 up to 10 ms, then LI 3 / stratum 16. PPS coming
+// back relocks at stratum 1.
+void holdover_demotes() {
+    sim_start();
+    run(60, 1, 150, true);
+
+    TimebaseStatus st;
+    TimebaseQuality q;
+    timebase_get_status(&st);
+    CHECK(timebase_get_quality(&q));
+    CHECK(st.synced);
+    CHECK(!st.holdover);
+    CHECK_EQ(q.stratum, 1);
+    CHECK_EQ(q.leap, 0);
+    const uint64_t e0 = st.error_ns;
+    CHECK(e0 > 0 && e0 < 10000);
+
+    uint32_t to_stratum2_s = 0, to_stratum16_s = 0;
+    for (uint32_t min = 1; min <= 6 * 60; ++min) {
+        run(60, 0, 0, false, 1000);
+        timebase_get_status(&st);
+        CHECK(timebase_get_quality(&q));
+        CHECK(st.holdover);
+        CHECK(q.holdover);
+        CHECK(!st.synced);
+
+        const uint64_t t = st.holdover_s;
+        CHECK(t + 61 >= min * 60ull && t <= min * 60ull + 1);
+        const uint64_t bound = e0 + 50 * t + 200 * t * t / 7200;
+        CHECK_EQ(st.error_ns, bound);
+        // NTP short format (16.16 s), rounded up
+        CHECK_EQ(q.root_dispersion, (bound << 16) / 1000000000ull + 1);
+
+        const uint8_t want = bound <= 100000 ? 1 : bound <= 10000000 ? 2 : 16;
+        CHECK_EQ(q.stratum, want);
+        CHECK_EQ(q.leap, want == 16 ? 3 : 0);
+        if (want == 2 && !to_stratum2_s) to_stratum2_s = static_cast<uint32_t>(t);
+        if (want == 16 && !to_stratum16_s) to_stratum16_s = static_cast<uint32_t>(t);
+    }
+    std::printf("  stratum 2 after %u s, stratum 16 after %u s\n", to_stratum2_s, to_stratum16_s);
+    CHECK(to_stratum2_s >= 18 * 60 && to_stratum2_s <= 22 * 60);
+    CHECK(to_stratum16_s >= 5 * 3600 - 600 && to_stratum16_s <= 5 * 3600 + 600);
+
+    run(60, 1, 150, true);
+    timebase_get_status(&st);
+    CHECK(timebase_get_quality(&q));
+    CHECK(st.synced);
+    CHECK(!st.holdover);
+    CHECK_EQ(q.stratum, 1);
+    CHECK_EQ(q.leap, 0);
+    CHECK(error_ns(g_sim.now_ms) > -50000 && error_ns(g_sim.now_ms) < 50000);
+}
+
+} // namespace
+
+extern const TestCase k_timebase_tests[] = {
+    {"rmc_1hz_labels_edge",          rmc_1hz_labels_edge},
+    {"rmc_10hz_whole_second_labels", rmc_10hz_whole_second_labels},
+    {"holdover_demotes",             holdover_demotes},
+    {nullptr, nullptr},
+};
@@ -0,0 +1,683 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "bench.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "timebase.h"
+#include "ntp_packet.h"
+#include "client_log.h"
+#include "gps_state.h"
+#include "gps_uart.h"
+#include "nmea.h"
+#include "servo.h"
+#include "snapshot.h"
+#include "bench_legacy.h"
+#include "hardware/timer.h"
+
+#if NTPSERVER_HOST_BUILD
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "host_hal.h"
+#else
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/uart.h"
+#include "hardware/structs/systick.h"
+#include "lwip/pbuf.h"
+#include "lwip/ip4.h"
+#include "lwip/prot/ip4.h"
+#include "lwip/prot/udp.h"
+#include "lwip/inet_chksum.h"
+#include "lwip/netif.h"
+#include "pico/cyw43_arch.h"
+#include "ntp_server.h"
+#endif
+
+namespace {
+
+uint32_t g_samples[BENCH_MAX_RUNS];
+uint32_t g_overhead = 0;
+
+#if NTPSERVER_HOST_BUILD
+
+constexpr const char* TICK_UNIT = "ns";
+
+void ticks_init() {}
+
+inline uint32_t ticks_now() {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+inline uint32_t ticks_elapsed(uint32_t start, uint32_t end) { return end - start; }
+
+uint32_t ticks_per_sec() { return 1000000000u; }
+
+#else
+
+constexpr const char* TICK_UNIT = "cyc";
+
+// SysTick as a free-running 24-bit down-counter on the processor clock.
+// Wraps every ~134 ms at 125 MHz, far longer than anything timed here.
+void ticks_init() {
+    systick_hw->csr = 0;
+    systick_hw->rvr = 0x00FFFFFFu;
+    systick_hw->cvr = 0;
+    systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+}
+
+inline uint32_t ticks_now() { return systick_hw->cvr; }
+
+inline uint32_t ticks_elapsed(uint32_t start, uint32_t end) {
+    return (start - end) & 0x00FFFFFFu;
+}
+
+uint32_t ticks_per_sec() { return clock_get_hz(clk_sys); }
+
+#endif
+
+void noop(void*) {}
+
+// ---- cases ----
+
+constexpr uint32_t RUNS = 512;
+
+const char k_rmc[] = "$GPRMC,141320.00,A,4807.038,N,01131.000,E,0.0,0.0,210926,,,A*57";
+const char k_gga[] = "$GPGGA,141320.00,4807.038,N,01131.000,E,1,09,0.9,545.4,M,46.9,M,,*60";
+
+// One second of GPS+GLONASS output as an L76 sends it at 9600 baud.
+const char k_capture[] =
+    "$GNRMC,141320.000,A,4807.0380,N,01131.0000,E,0.02,211.35,210926,,,A*7F\r\n"
+    "$GNVTG,211.35,T,,M,0.02,N,0.04,K,A*21\r\n"
+    "$GNGGA,141320.000,4807.0380,N,01131.0000,E,1,12,0.86,545.4,M,46.9,M,,*73\r\n"
+    "$GNGSA,A,3,05,13,15,18,20,23,24,29,,,,,1.46,0.86,1.18*1D\r\n"
+    "$GNGSA,A,3,67,68,77,78,,,,,,,,,1.46,0.86,1.18*19\r\n"
+    "$GPGSV,3,1,12,05,44,298,34,13,58,071,39,15,47,190,41,18,21,108,33*73\r\n"
+    "$GPGSV,3,2,12,20,30,050,36,23,17,265,30,24,63,122,42,29,38,315,37*78\r\n"
+    "$GPGSV,3,3,12,10,05,030,,12,03,330,,25,02,170,,32,01,210,*7D\r\n"
+    "$GLGSV,2,1,07,67,45,082,35,68,72,279,38,69,21,312,,77,34,061,33*6D\r\n"
+    "$GLGSV,2,2,07,78,68,140,40,79,29,205,,86,08,015,*52\r\n"
+    "$GNGLL,4807.0380,N,01131.0000,E,141320.000,A,A*40\r\n"
+    "$GNZDA,141320.000,21,09,2026,,*41\r\n";
+constexpr uint32_t CAPTURE_LINES = 12;
+
+void case_now_ntp(void*) {
+    uint32_t s, f;
+    (void)timebase_now_ntp(&s, &f);
+}
+
+struct FillCtx {
+    NtpPacket pkt;
+    uint32_t  t2s, t2f;
+};
+
+void setup_fill(void* ctx) {
+    FillCtx* c = static_cast<FillCtx*>(ctx);
+    std::memset(&c->pkt, 0, sizeof(c->pkt));
+    c->pkt.li_vn_mode = ntp_make_li_vn_mode(0, 4, 3);
+    c->pkt.tx_ts_s = hton32(0xEE5A1234u);
+    c->pkt.tx_ts_f = hton32(0x80000000u);
+}
+
+// Same layout as the timebase's published Snapshot.
+struct SnapBench {
+    ServoModel model;
+    uint32_t   ref_ntp_s;
+    bool       have_time;
+    bool       synced;
+    uint64_t   pps_edge_us;
+};
+
+SeqSnapshot<SnapBench> g_snap;
+
+// A local time half a second past the model's reference, converted by the
+// timebase and by the old dividing path (same seqlock read in front).
+struct ConvCtx {
+    uint64_t local_us;
+};
+
+void case_local_to_ntp(void* ctx) {
+    uint32_t s, f;
+    (void)timebase_local_to_ntp(static_cast<ConvCtx*>(ctx)->local_us, &s, &f);
+}
+
+void case_local_to_ntp_legacy(void* ctx) {
+    SnapBench v;
+    uint32_t s, f;
+    if (g_snap.read(&v)) legacy_model_to_ntp(&v.model, static_cast<ConvCtx*>(ctx)->local_us, &s, &f);
+}
+
+void case_fill(void* ctx) {
+    FillCtx* c = static_cast<FillCtx*>(ctx);
+    uint32_t t3s = 0, t3f = 0;
+    (void)timebase_now_ntp(&t3s, &t3f);
+    ntp_fill_response(&c->pkt, &c->pkt, c->t2s, c->t2f, t3s, t3f, false);
+}
+
+// ---- Rate-limit admission ----
+
+// ntp_admit() without the KoD send: the client lookup and token bucket,
+// with the server's limits (1 request / 2 s, burst 8).
+constexpr uint32_t ADMIT_INTERVAL_TICKS = (2000u * 1000u) >> 10;
+constexpr uint32_t ADMIT_BURST          = 8;
+constexpr uint32_t ADMIT_CLIENTS        = 32;   // resident set for the hit cases
+
+struct AdmitCtx {
+    uint32_t next_ip   = 0xC0000200u;  // 192.0.2.0 and up
+    uint32_t tick      = 0;
+    uint32_t tick_step = 0;            // added per call; 0 = same instant
+    uint32_t i         = 0;
+    bool     fresh     = false;        // a new client every call
+    bool     keep_free = false;        // clear the table before it fills
+    bool     allowed   = false;
+};
+
+bool admit(uint32_t ip, uint32_t now_tick) {
+    return client_log_allow(client_log_get(ip), now_tick, ADMIT_INTERVAL_TICKS, ADMIT_BURST);
+}
+
+void setup_admit(void* ctx) {
+    AdmitCtx* c = static_cast<AdmitCtx*>(ctx);
+    c->tick += c->tick_step;
+    if (!c->fresh) return;
+    if (c->keep_free) {
+        ClientLogStats st;
+        client_log_get_stats(&st);
+        if (st.resident >= CLIENT_LOG_SIZE / 2) client_log_clear();
+    }
+    c->next_ip++;
+}
+
+void case_admit(void* ctx) {
+    AdmitCtx* c = static_cast<AdmitCtx*>(ctx);
+    const uint32_t ip = c->fresh ? c->next_ip : (0xC0000200u + (c->i++ % ADMIT_CLIENTS));
+    c->allowed = admit(ip, c->tick);
+}
+
+void bench_admit() {
+    BenchResult r;
+    ClientLogStats st;
+
+    // Hit: resident clients, bucket refilled between calls
+    client_log_clear();
+    for (uint32_t i = 0; i < ADMIT_CLIENTS; ++i) (void)admit(0xC0000200u + i, 0);
+    AdmitCtx hit{};
+    hit.tick_step = ADMIT_INTERVAL_TICKS;
+    bench_run("admit hit", RUNS, setup_admit, case_admit, &hit, &r);
+    bench_print(&r);
+
+    // Hit, over the limit: every call after the burst is refused
+    AdmitCtx limited{};
+    limited.tick = hit.tick;
+    for (uint32_t i = 0; i < ADMIT_CLIENTS * ADMIT_BURST; ++i) {
+        (void)admit(0xC0000200u + (i % ADMIT_CLIENTS), limited.tick);
+    }
+    bench_run("admit limited", RUNS, setup_admit, case_admit, &limited, &r);
+    bench_print(&r);
+
+    // Miss into a free slot
+    client_log_clear();
+    AdmitCtx insert{};
+    insert.fresh     = true;
+    insert.keep_free = true;
+    bench_run("admit insert", RUNS, setup_admit, case_admit, &insert, &r);
+    bench_print(&r);
+
+    // Miss with every probe slot taken: LRU eviction
+    client_log_clear();
+    AdmitCtx evict{};
+    evict.fresh     = true;
+    evict.tick_step = 1;
+    evict.next_ip   = 0x0A000000u;   // 10.0.0.0 and up
+    for (uint32_t i = 0; i < 16 * CLIENT_LOG_SIZE; ++i) (void)admit(++evict.next_ip, 0);
+    client_log_get_stats(&st);
+    const uint32_t evictions = st.evictions;
+    bench_run("admit evict", RUNS, setup_admit, case_admit, &evict, &r);
+    bench_print(&r);
+    client_log_get_stats(&st);
+    std::printf("  (%lu/%lu evicted)\r\n", (unsigned long)(st.evictions - evictions), (unsigned long)RUNS);
+
+    client_log_clear();
+}
+
+void case_tokenize(void* ctx) {
+    NmeaSentence s;
+    (void)nmea_tokenize(static_cast<const char*>(ctx), &s);
+}
+
+void case_update_from_nmea(void* ctx) {
+    update_from_nmea(static_cast<const char*>(ctx));
+}
+
+// k_capture split into NUL-terminated sentences, as get_line() returns them.
+// One timed run handles the whole second of output, so the per-sentence
+// figure covers the mix the GPS loop really sees (mostly sentences that are
+// dispatched and then ignored).
+char g_capture_lines[CAPTURE_LINES][GPS_LINE_MAX + 1];
+
+void split_capture() {
+    const char* p = k_capture;
+    for (uint32_t i = 0; i < CAPTURE_LINES; ++i) {
+        size_t n = 0;
+        while (p[n] != '\r' && n < GPS_LINE_MAX) { g_capture_lines[i][n] = p[n]; ++n; }
+        g_capture_lines[i][n] = '\0';
+        p += n + 2;
+    }
+}
+
+void case_capture(void*) {
+    for (uint32_t i = 0; i < CAPTURE_LINES; ++i) update_from_nmea(g_capture_lines[i]);
+}
+
+void case_capture_legacy(void*) {
+    for (uint32_t i = 0; i < CAPTURE_LINES; ++i) legacy_update_from_nmea(g_capture_lines[i]);
+}
+
+// The fields gps_state reads from one second of output (GGA sats/HDOP, RMC
+// time/date, ZDA), converted without the sentence walk around them.
+struct FieldsCtx {
+    NmeaSentence rmc, gga, zda;
+    LegacyFields legacy;
+};
+
+volatile int32_t g_sink;
+
+void setup_fields(FieldsCtx* c) {
+    (void)nmea_tokenize(g_capture_lines[0], &c->rmc);
+    (void)nmea_tokenize(g_capture_lines[2], &c->gga);
+    (void)nmea_tokenize(g_capture_lines[11], &c->zda);
+    c->legacy = LegacyFields{c->gga.at(7).p, c->gga.at(8).p, c->rmc.at(1).p, c->rmc.at(9).p,
+                             c->zda.at(1).p, c->zda.at(2).p, c->zda.at(3).p, c->zda.at(4).p};
+}
+
+void case_fields(void* ctx) {
+    const FieldsCtx* c = static_cast<const FieldsCtx*>(ctx);
+    uint32_t sats = 0, dd = 0, mm = 0, yyyy = 0;
+    int32_t hdop = 0, rmc_ms = 0, zda_ms = 0, year = 0, mon = 0, day = 0;
+    bool ok = nmea_parse_u32(c->gga.at(7), &sats);
+    ok &= nmea_parse_fixed(c->gga.at(8), 2, &hdop);
+    ok &= nmea_parse_time_ms(c->rmc.at(1), &rmc_ms);
+    ok &= nmea_parse_ddmmyy(c->rmc.at(9), &year, &mon, &day);
+    ok &= nmea_parse_time_ms(c->zda.at(1), &zda_ms);
+    ok &= nmea_parse_u32(c->zda.at(2), &dd) && nmea_parse_u32(c->zda.at(3), &mm) &&
+          nmea_parse_u32(c->zda.at(4), &yyyy);
+    g_sink = ok ? (int32_t)(sats + hdop + rmc_ms + zda_ms + year + mon + day + dd + mm + yyyy) : -1;
+}
+
+void case_fields_legacy(void* ctx) {
+    g_sink = legacy_convert_fields(static_cast<const FieldsCtx*>(ctx)->legacy);
+}
+
+void print_per_sentence(const BenchResult* r) {
+    const uint32_t per = r->median / CAPTURE_LINES;
+    std::printf("  (%lu %s/sentence, %lu sentences/s)\r\n", (unsigned long)per, TICK_UNIT,
+                (unsigned long)(per ? ticks_per_sec() / per : 0u));
+}
+
+// ---- GPS line extraction ----
+
+char g_line[GPS_LINE_MAX + 1];
+
+#if NTPSERVER_HOST_BUILD
+
+bool feed_uart(const char* s, size_t len) { return host_uart_rx(s, len) == len; }
+
+#else
+
+// The UART's internal loopback (TX -> RX) puts bytes through the real
+// receive path, DMA or IRQ. Runs at 115200 so each line takes ~7 ms.
+constexpr uint32_t LOOPBACK_BAUD = 115200;
+constexpr uint32_t GPS_BAUD      = 9600;
+
+void loopback(bool on) {
+    hw_write_masked(&uart_get_hw(uart0)->cr, on ? UART_UARTCR_LBE_BITS : 0u, UART_UARTCR_LBE_BITS);
+    uart_set_baudrate(uart0, on ? LOOPBACK_BAUD : GPS_BAUD);
+}
+
+bool feed_uart(const char* s, size_t len) {
+    uart_write_blocking(uart0, reinterpret_cast<const uint8_t*>(s), len);
+    uart_tx_wait_blocking(uart0);
+    // RX timeout interrupt (IRQ mode) fires after 32 bit times
+    sleep_ms(1);
+    return true;
+}
+
+#endif
+
+void drain_lines() {
+    while (GpsUart::get_line(g_line, sizeof(g_line))) {}
+}
+
+// The capture arrives one byte at a time with get_line() polled after each,
+// the way the GPS loop sees it at 9600 baud. Each sample is one poll; the
+// median is the cost of looking at one new byte, the max a completed line.
+struct FeedCtx {
+    size_t   pos   = 0;
+    uint32_t lines = 0;
+};
+
+void setup_feed_byte(void* ctx) {
+    FeedCtx* c = static_cast<FeedCtx*>(ctx);
+    (void)feed_uart(&k_capture[c->pos], 1);
+    c->pos = (c->pos + 1) % (sizeof(k_capture) - 1);
+}
+
+void case_poll_line(void* ctx) {
+    if (GpsUart::get_line(g_line, sizeof(g_line))) static_cast<FeedCtx*>(ctx)->lines++;
+}
+
+// ---- Snapshot reads under a concurrent writer (host only) ----
+
+#if NTPSERVER_HOST_BUILD
+
+std::atomic<bool> g_writer_run{false};
+
+void snap_writer(uint32_t period_us) {
+    SnapBench v{};
+    while (g_writer_run.load(std::memory_order_relaxed)) {
+        v.ref_ntp_s++;
+        v.pps_edge_us += 1000000u;
+        g_snap.publish(v);
+        if (period_us) std::this_thread::sleep_for(std::chrono::microseconds(period_us));
+    }
+}
+
+// Every read for duration_ms while a thread publishes each period_us (0 =
+// back to back). Too many samples for g_samples, so they go into a 1-tick
+// histogram; anything past its end counts as the last bucket.
+constexpr uint32_t SNAP_HIST = 4096;
+uint32_t g_snap_hist[SNAP_HIST];
+
+void bench_snapshot(const char* name, uint32_t period_us, uint32_t duration_ms) {
+    std::memset(g_snap_hist, 0, sizeof(g_snap_hist));
+    SnapBench v{};
+    g_snap.publish(v);
+
+    g_writer_run = true;
+    std::thread writer(snap_writer, period_us);
+
+    volatile uint32_t retries = 0;
+    uint32_t reads = 0, failed = 0, max = 0;
+    const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(duration_ms);
+    while (std::chrono::steady_clock::now() < end) {
+        for (uint32_t i = 0; i < 1000; ++i) {
+            const uint32_t t0 = ticks_now();
+            const bool ok = g_snap.read(&v, 8, &retries);
+            const uint32_t t1 = ticks_now();
+            uint32_t dt = ticks_elapsed(t0, t1);
+            dt = (dt > g_overhead) ? (dt - g_overhead) : 0u;
+            if (dt > max) max = dt;
+            g_snap_hist[std::min(dt, SNAP_HIST - 1u)]++;
+            if (!ok) failed++;
+            reads++;
+        }
+    }
+
+    g_writer_run = false;
+    writer.join();
+
+    // Percentiles straight from the histogram
+    auto pct = [&](uint64_t rank) {
+        uint64_t n = 0;
+        for (uint32_t t = 0; t < SNAP_HIST; ++t) if ((n += g_snap_hist[t]) > rank) return t;
+        return SNAP_HIST - 1u;
+    };
+    BenchResult r;
+    r.name   = name;
+    r.runs   = reads;
+    r.min    = pct(0);
+    r.median = pct(reads / 2u);
+    r.p99    = pct((uint64_t)reads * 99u / 100u);
+    r.max    = max;
+    bench_print(&r);
+    std::printf("  (%lu retries, %lu failed reads)\r\n", (unsigned long)retries, (unsigned long)failed);
+}
+
+#endif
+
+// ---- UDP receive callback (target only: the host build has no lwIP) ----
+
+#if !NTPSERVER_HOST_BUILD
+
+// Rotate through enough clients that none exceeds the rate-limit burst.
+constexpr uint32_t RX_CLIENTS = 64;
+
+struct RxCtx {
+    pbuf*    p;
+    uint32_t n;
+    bool     fresh;   // a new client every request: admission evicts
+};
+
+void setup_rx(void* ctx) {
+    RxCtx* c = static_cast<RxCtx*>(ctx);
+    c->p = pbuf_alloc(PBUF_TRANSPORT, sizeof(NtpPacket), PBUF_RAM);
+    if (!c->p) return;
+
+    NtpPacket req{};
+    req.li_vn_mode = ntp_make_li_vn_mode(0, 4, 3);
+    req.tx_ts_s = hton32(0xEE5A1234u);
+    req.tx_ts_f = hton32(c->n);
+    pbuf_take(c->p, &req, sizeof(req));
+    c->n++;
+}
+
+void case_rx(void* ctx) {
+    RxCtx* c = static_cast<RxCtx*>(ctx);
+    if (!c->p) return;
+    // 192.0.2.x (TEST-NET-1), or 10.x.x.x when fresh; network order
+    const uint32_t ip = lwip_htonl(c->fresh ? (0x0A000000u + c->n) : (0xC0000200u | (c->n % RX_CLIENTS)));
+    ntp_server_bench_rx(c->p, ip, 40000);
+    c->p = nullptr;
+}
+
+// The same request as a whole IPv4/UDP frame to our address, through
+// ip4_input(): answered by the input hook with NTP_FAST_PATH, by
+// udp_input() -> on_ntp_rx() without. Build both ways to compare.
+constexpr u16_t IP4_FRAME_LEN = IP_HLEN + UDP_HLEN + sizeof(NtpPacket);
+
+void setup_ip4(void* ctx) {
+    RxCtx* c = static_cast<RxCtx*>(ctx);
+    c->p = netif_default ? pbuf_alloc(PBUF_LINK, IP4_FRAME_LEN, PBUF_RAM) : nullptr;
+    if (!c->p) return;
+
+    auto* iph = static_cast<ip_hdr*>(c->p->payload);
+    std::memset(iph, 0, IP_HLEN);
+    IPH_VHL_SET(iph, 4, IP_HLEN / 4);
+    IPH_LEN_SET(iph, lwip_htons(IP4_FRAME_LEN));
+    IPH_TTL_SET(iph, 64);
+    IPH_PROTO_SET(iph, IP_PROTO_UDP);
+    ip4_addr_set_u32(&iph->src, lwip_htonl(0xC0000200u | (c->n % RX_CLIENTS)));
+    ip4_addr_copy(iph->dest, *netif_ip4_addr(netif_default));
+    IPH_CHKSUM_SET(iph, inet_chksum(iph, IP_HLEN));
+
+    auto* udph = reinterpret_cast<udp_hdr*>(reinterpret_cast<uint8_t*>(iph) + IP_HLEN);
+    udph->src    = PP_HTONS(40000);
+    udph->dest   = PP_HTONS(123);
+    udph->len    = lwip_htons(UDP_HLEN + sizeof(NtpPacket));
+    udph->chksum = 0;
+
+    NtpPacket req{};
+    req.li_vn_mode = ntp_make_li_vn_mode(0, 4, 3);
+    req.tx_ts_s = hton32(0xEE5A1234u);
+    req.tx_ts_f = hton32(c->n);
+    std::memcpy(reinterpret_cast<uint8_t*>(udph) + UDP_HLEN, &req, sizeof(req));
+    c->n++;
+}
+
+void case_ip4(void* ctx) {
+    RxCtx* c = static_cast<RxCtx*>(ctx);
+    if (!c->p) return;
+    (void)ip4_input(c->p, netif_default);
+    c->p = nullptr;
+}
+
+#endif
+
+} // namespace
+
+bool bench_run(const char* name, uint32_t runs,
+               bench_fn_t setup, bench_fn_t fn, void* ctx, BenchResult* out) {
+    if (!fn || !out || runs == 0) return false;
+    if (runs > BENCH_MAX_RUNS) runs = BENCH_MAX_RUNS;
+
+    for (uint32_t i = 0; i < runs; ++i) {
+        if (setup) setup(ctx);
+        const uint32_t t0 = ticks_now();
+        fn(ctx);
+        const uint32_t t1 = ticks_now();
+        const uint32_t dt = ticks_elapsed(t0, t1);
+        g_samples[i] = (dt > g_overhead) ? (dt - g_overhead) : 0u;
+    }
+    std::sort(g_samples, g_samples + runs);
+
+    out->name   = name;
+    out->runs   = runs;
+    out->min    = g_samples[0];
+    out->median = g_samples[runs / 2];
+    out->p99    = g_samples[(runs * 99u + 99u) / 100u - 1u];
+    out->max    = g_samples[runs - 1];
+    return true;
+}
+
+void bench_print(const BenchResult* r) {
+    if (!r) return;
+    std::printf("  %-22s n=%-4lu min %7lu  med %7lu  p99 %7lu  max %7lu %s\r\n",
+                r->name, (unsigned long)r->runs, (unsigned long)r->min,
+                (unsigned long)r->median, (unsigned long)r->p99,
+                (unsigned long)r->max, TICK_UNIT);
+}
+
+void bench_run_all() {
+    ticks_init();
+
+    // Timestamp cost: the minimum over an empty call.
+    BenchResult r;
+    g_overhead = 0;
+    bench_run("overhead", RUNS, nullptr, noop, nullptr, &r);
+    g_overhead = r.min;
+
+#if NTPSERVER_HOST_BUILD
+    std::printf("BENCH: steady_clock (%s), overhead %lu\r\n", TICK_UNIT, (unsigned long)g_overhead);
+#else
+    std::printf("BENCH: SysTick @ %lu MHz (%s), overhead %lu\r\n",
+                (unsigned long)(clock_get_hz(clk_sys) / 1000000u), TICK_UNIT,
+                (unsigned long)g_overhead);
+#endif
+
+#if !NTP_MULTICORE
+    // A PPS-less coarse fix, so the read path evaluates a real model.
+    // (With NTP_MULTICORE core1 owns the timebase and GPS; only reads here.)
+    update_from_nmea(k_rmc);
+#endif
+
+    bench_run("timebase_now_ntp", RUNS, nullptr, case_now_ntp, nullptr, &r);
+    bench_print(&r);
+
+    SnapBench legacy{};
+    legacy.model.ref_local_us = time_us_64();
+    legacy.model.ref_unix_s   = 1790000000u;
+    legacy.model.ref_ns       = 999999000u;
+    legacy.model.rate_q32     = 313532;     // +73 ppm
+    legacy.have_time          = true;
+    g_snap.publish(legacy);
+    ConvCtx conv{time_us_64() + 500000u};
+    bench_run("local_to_ntp", RUNS, nullptr, case_local_to_ntp, &conv, &r);
+    bench_print(&r);
+    bench_run("local_to_ntp (legacy)", RUNS, nullptr, case_local_to_ntp_legacy, &conv, &r);
+    bench_print(&r);
+
+#if NTPSERVER_HOST_BUILD
+    bench_snapshot("snapshot read @10 Hz", 100000, 1050);
+    bench_snapshot("snapshot read @max", 0, 250);
+#endif
+
+    bench_admit();
+
+    FillCtx fill{};
+    (void)timebase_now_ntp(&fill.t2s, &fill.t2f);
+    bench_run("ntp_fill_response", RUNS, setup_fill, case_fill, &fill, &r);
+    bench_print(&r);
+
+#if !NTPSERVER_HOST_BUILD
+    RxCtx rx{};
+    RxCtx rx_new{};
+    rx_new.fresh = true;
+    BenchResult r_new;
+    cyw43_arch_lwip_begin();
+    bench_run("on_ntp_rx", 256, setup_rx, case_rx, &rx, &r);
+    bench_run("on_ntp_rx (new client)", 256, setup_rx, case_rx, &rx_new, &r_new);
+    cyw43_arch_lwip_end();
+    if (rx.p) pbuf_free(rx.p);
+    if (rx_new.p) pbuf_free(rx_new.p);
+    bench_print(&r);
+    bench_print(&r_new);
+
+    RxCtx ip4{};
+    cyw43_arch_lwip_begin();
+#if NTP_FAST_PATH
+    bench_run("ip4_input (fast path)", 256, setup_ip4, case_ip4, &ip4, &r);
+#else
+    bench_run("ip4_input (udp_recv)", 256, setup_ip4, case_ip4, &ip4, &r);
+#endif
+    cyw43_arch_lwip_end();
+    if (ip4.p) pbuf_free(ip4.p);
+    bench_print(&r);
+#endif
+
+    bench_run("nmea_tokenize(GGA)", RUNS, nullptr, case_tokenize,
+              const_cast<char*>(k_gga), &r);
+    bench_print(&r);
+
+    split_capture();
+    FieldsCtx fields;
+    setup_fields(&fields);
+    bench_run("nmea fields", RUNS, nullptr, case_fields, &fields, &r);
+    bench_print(&r);
+    bench_run("nmea fields (legacy)", RUNS, nullptr, case_fields_legacy, &fields, &r);
+    bench_print(&r);
+
+#if !NTP_MULTICORE
+    bench_run("update_from_nmea(RMC)", RUNS, nullptr, case_update_from_nmea,
+              const_cast<char*>(k_rmc), &r);
+    bench_print(&r);
+    bench_run("update_from_nmea(GGA)", RUNS, nullptr, case_update_from_nmea,
+              const_cast<char*>(k_gga), &r);
+    bench_print(&r);
+
+    bench_run("nmea capture", RUNS, nullptr, case_capture, nullptr, &r);
+    bench_print(&r);
+    print_per_sentence(&r);
+    bench_run("nmea capture (legacy)", RUNS, nullptr, case_capture_legacy, nullptr, &r);
+    bench_print(&r);
+    print_per_sentence(&r);
+
+#if !NTPSERVER_HOST_BUILD
+    loopback(true);
+#endif
+    drain_lines();
+    FeedCtx feed{};
+    bench_run("get_line per byte", sizeof(k_capture) - 1, setup_feed_byte, case_poll_line, &feed, &r);
+#if !NTPSERVER_HOST_BUILD
+    loopback(false);
+#endif
+    bench_print(&r);
+    std::printf("  (%lu-byte capture, %lu/%lu lines)\r\n", (unsigned long)(sizeof(k_capture) - 1),
+                (unsigned long)feed.lines, (unsigned long)CAPTURE_LINES);
+
+    timebase_clear();
+#endif
+}
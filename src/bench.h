@@ -0,0 +1,45 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <cstdint>
+
+// Microbenchmarks for the request/receive hot path (NTP_BENCH builds and the
+// host bench). Ticks are CPU cycles from SysTick on the RP2040, nanoseconds
+// from a monotonic clock on the host; the fixed cost of taking a timestamp
+// is measured once and subtracted.
+
+constexpr uint32_t BENCH_MAX_RUNS = 1024;
+
+struct BenchResult {
+    const char* name   = nullptr;
+    uint32_t    runs   = 0;
+    uint32_t    min    = 0;
+    uint32_t    median = 0;
+    uint32_t    p99    = 0;
+    uint32_t    max    = 0;
+};
+
+typedef void (*bench_fn_t)(void* ctx);
+
+// Time fn(ctx) `runs` times (capped at BENCH_MAX_RUNS). setup(ctx), if given,
+// runs before each call outside the timed region.
+bool bench_run(const char* name, uint32_t runs,
+               bench_fn_t setup, bench_fn_t fn, void* ctx, BenchResult* out);
+
+void bench_print(const BenchResult* r);
+
+// The standard suite: timebase reads, reply construction, NMEA parsing, GPS
+// line extraction and (on target) the UDP receive callback. Expects
+// timebase_init() and gps_task_init() to have run on this core. Leaves the
+// timebase cleared.
+void bench_run_all();
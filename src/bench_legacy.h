@@ -0,0 +1,48 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <cstdint>
+
+#include "servo.h"
+
+// Superseded implementations kept only as benchmark baselines (NTP_BENCH
+// builds and the host bench). Nothing else may call these.
+
+// The timestamp conversion before the cached epoch: servo_model_eval()
+// (64-bit / and % by 1e9) and the fraction as (nsec << 32) / 1e9.
+void legacy_model_to_ntp(const ServoModel* m, uint64_t local_us,
+                         uint32_t* ntp_seconds, uint32_t* ntp_fraction);
+
+// The NMEA handling before the tokenizer: prefix dispatch, a comma scanner
+// per sentence type, no checksum, strtol/strtof and snprintf for fields.
+// Writes a private status copy; RMC still feeds the timebase and every
+// handled sentence runs gps_state_service(), as the original did.
+void legacy_update_from_nmea(const char* line);
+
+// Field conversions only, the way the comma-scanning parsers did them. Each
+// pointer is the start of a field inside a sentence (it ends at ',' or '*').
+struct LegacyFields {
+    const char* sats;       // GGA
+    const char* hdop;
+    const char* rmc_time;   // RMC
+    const char* rmc_date;
+    const char* zda_time;   // ZDA
+    const char* zda_dd;
+    const char* zda_mm;
+    const char* zda_yyyy;
+};
+
+// Converts one second's worth of fields: sats/HDOP through strtol/strtof,
+// RMC time and date copied then parsed, ZDA checked and formatted with
+// snprintf. Returns the RMC's UTC second of day, or -1.
+int32_t legacy_convert_fields(const LegacyFields& f);
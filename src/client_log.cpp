@@ -0,0 +1,122 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "client_log.h"
+
+namespace {
+
+static_assert(CLIENT_LOG_PROBE <= CLIENT_LOG_SIZE, "probe window larger than table");
+
+constexpr uint32_t SIZE_MASK = CLIENT_LOG_SIZE - 1;
+
+struct ClientLog {
+    ClientEntry slots[CLIENT_LOG_SIZE];
+    uint32_t tick = 0;
+    ClientLogStats stats{};
+};
+
+ClientLog g_log;
+
+inline void touch(ClientEntry* e) {
+    e->last_use = ++g_log.tick;
+}
+
+} // namespace
+
+uint32_t client_log_home_slot(uint32_t addr) {
+    // Fibonacci hashing: the top bits of the product. Low address bits
+    // alone cluster badly on one subnet.
+    return (addr * 2654435769u) >> (32 - CLIENT_LOG_BITS);
+}
+
+ClientEntry* client_log_find(uint32_t addr) {
+    if (addr == 0) return nullptr;
+
+    const uint32_t h = client_log_home_slot(addr);
+    for (uint32_t i = 0; i < CLIENT_LOG_PROBE; ++i) {
+        ClientEntry* e = &g_log.slots[(h + i) & SIZE_MASK];
+        if (e->addr == addr) {
+            touch(e);
+            return e;
+        }
+        if (e->addr == 0) break;   // slots fill in probe order, never freed
+    }
+    return nullptr;
+}
+
+ClientEntry* client_log_get(uint32_t addr) {
+    if (addr == 0) return nullptr;
+
+    const uint32_t h = client_log_home_slot(addr);
+    ClientEntry* victim = nullptr;
+
+    for (uint32_t i = 0; i < CLIENT_LOG_PROBE; ++i) {
+        ClientEntry* e = &g_log.slots[(h + i) & SIZE_MASK];
+        if (e->addr == addr) {
+            touch(e);
+            return e;
+        }
+        if (e->addr == 0) {
+            victim = e;
+            g_log.stats.resident++;
+            break;
+        }
+        // Wrap-safe "older than": the stamp furthest behind the tick.
+        if (!victim || (g_log.tick - e->last_use) > (g_log.tick - victim->last_use)) {
+            victim = e;
+        }
+    }
+
+    if (victim->addr != 0) g_log.stats.evictions++;
+    g_log.stats.inserts++;
+
+    *victim = ClientEntry{};
+    victim->addr = addr;
+    touch(victim);
+    return victim;
+}
+
+bool client_log_allow(ClientEntry* e, uint32_t now_tick,
+                      uint32_t interval_ticks, uint32_t burst) {
+    if (!e) return true;
+
+    const uint32_t cap = interval_ticks * burst;
+
+    if (!e->bucket_init) {
+        // New client: start with a full bucket (iburst fits).
+        e->credit      = cap;
+        e->bucket_init = true;
+    } else {
+        const uint32_t elapsed = now_tick - e->last_tick;
+        e->credit = (elapsed >= cap - e->credit) ? cap : (e->credit + elapsed);
+    }
+    e->last_tick = now_tick;
+
+    if (e->credit < interval_ticks) return false;
+    e->credit -= interval_ticks;
+    return true;
+}
+
+bool client_log_kod_due(ClientEntry* e, uint32_t now_tick, uint32_t interval_ticks) {
+    if (!e || now_tick - e->last_kod_tick < interval_ticks) return false;
+    e->last_kod_tick = now_tick;
+    return true;
+}
+
+void client_log_clear() {
+    g_log = ClientLog{};
+}
+
+void client_log_get_stats(ClientLogStats* out) {
+    if (!out) return;
+    *out = g_log.stats;
+}
@@ -0,0 +1,70 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <cstdint>
+
+// Per-client NTP state in a fixed-size open-addressing table (no heap).
+//
+// A client may live in any of CLIENT_LOG_PROBE slots starting at its hash.
+// When all of them are taken by other clients, the least recently used one
+// is recycled, so memory is bounded and busy clients stay resident.
+// Not thread-safe: call from the lwIP context only.
+
+constexpr uint32_t CLIENT_LOG_BITS  = 6;
+constexpr uint32_t CLIENT_LOG_SIZE  = 1u << CLIENT_LOG_BITS;
+constexpr uint32_t CLIENT_LOG_PROBE = 8;
+
+struct ClientEntry {
+    uint32_t addr = 0;       // IPv4, as stored by lwIP; 0 = never used
+    uint32_t last_use = 0;   // LRU stamp (client_log access counter)
+
+    // Interleaved mode: what we put in the receive field of our last
+    // reply (NTP, host order) and when that reply really left.
+    uint32_t rx_ts_s = 0, rx_ts_f = 0;
+    uint32_t tx_ts_s = 0, tx_ts_f = 0;
+
+    // Rate limiting: token bucket kept as time credit, in ticks
+    // (a tick is 1024 us, i.e. time_us_64() >> 10).
+    uint32_t credit    = 0;
+    uint32_t last_tick = 0;
+    uint32_t last_kod_tick = 0;
+    bool     bucket_init = false;
+};
+
+// Look up a client, inserting (and evicting the LRU slot) if needed.
+ClientEntry* client_log_get(uint32_t addr);
+
+// Look up only; nullptr if not resident.
+ClientEntry* client_log_find(uint32_t addr);
+
+void client_log_clear();
+
+// First slot probed for addr.
+uint32_t client_log_home_slot(uint32_t addr);
+
+// Token bucket: each request costs interval_ticks of credit, credit refills in
+// real time up to burst * interval_ticks. Returns true if the request may be
+// served. No division.
+bool client_log_allow(ClientEntry* e, uint32_t now_tick,
+                      uint32_t interval_ticks, uint32_t burst);
+
+// For a refused request: true (and restamped) if this client has had no
+// KoD for at least interval_ticks, so at most one goes out per interval.
+bool client_log_kod_due(ClientEntry* e, uint32_t now_tick, uint32_t interval_ticks);
+
+struct ClientLogStats {
+    uint32_t resident  = 0;
+    uint32_t inserts   = 0;
+    uint32_t evictions = 0;
+};
+void client_log_get_stats(ClientLogStats* out);
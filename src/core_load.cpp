@@ -0,0 +1,61 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "core_load.h"
+
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "pico/platform.h"
+
+namespace {
+
+constexpr uint64_t WINDOW_US = 1000000ULL;
+
+struct CoreLoad {
+    uint64_t window_start_us = 0;
+    uint64_t idle_us         = 0;
+    volatile uint32_t permille = 0;
+};
+
+CoreLoad g_load[2];
+
+} // namespace
+
+void core_load_idle() {
+    CoreLoad& cl = g_load[get_core_num() & 1u];
+
+    // With interrupts masked a pending IRQ still ends WFI, but its handler
+    // only runs after the restore, so handler time counts as busy, not idle.
+    const uint32_t save = save_and_disable_interrupts();
+    const uint64_t t0 = time_us_64();
+    __wfi();
+    const uint64_t t1 = time_us_64();
+    restore_interrupts(save);
+
+    if (cl.window_start_us == 0) {
+        cl.window_start_us = t0;
+        cl.idle_us = 0;
+    }
+    cl.idle_us += t1 - t0;
+
+    const uint64_t span = t1 - cl.window_start_us;
+    if (span < WINDOW_US) return;
+
+    const uint64_t busy = (span > cl.idle_us) ? (span - cl.idle_us) : 0;
+    cl.permille = static_cast<uint32_t>((busy * 1000ULL) / span);
+    cl.window_start_us = t1;
+    cl.idle_us = 0;
+}
+
+uint32_t core_load_permille(uint32_t core) {
+    return (core < 2) ? g_load[core].permille : 0;
+}
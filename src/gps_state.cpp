@@ -12,135 +12,25 @@
  */
 #include "gps_state.h"
 #include "timebase.h"
-#include "pps.h"
+#include "pps_stats.h"
 #include "hardware/timer.h"
+#include "snapshot.h"
 
 volatile GPSDeviceState g_state = GPSDeviceState::Booting;
 GpsStatus gps;
 
+// Copy of `gps` for readers on the other core (UI); republished after each
+// handled sentence.
+static SeqSnapshot<GpsStatus> g_gps_view;
+
 static bool pps_recent_and_1hz()
 {
-    // Need at least 2 edges so the interval is real.
-    const uint32_t edges = pps_get_edges();
-    if (edges < 2) return false;
-
-    // Interval sanity check (~1 Hz).
-    const uint32_t interval_us = pps_get_last_interval_us();
-    if (interval_us < 900000u || interval_us > 1100000u) return false;
-
-    // "Recent" check (PPS still present).
-    const uint64_t last_edge_us = pps_get_last_edge_us();
-    if (last_edge_us == 0) return false;
-
-    const uint64_t age_us = time_us_64() - last_edge_us;
-    if (age_us > 1500000ULL) return false;
-
-    return true;
-}
-
-// Very lightweight parsing (enough for display)
-static bool starts_with(const char* s, const char* p) {
-    while (*p) if (*s++ != *p++) return false;
-    return true;
-}
-
-static std::size_t field_len(const char* f) {
-    std::size_t n = 0;
-    while (f[n] && f[n] != ',' && f[n] != '*' && f[n] != '\r' && f[n] != '\n') n++;
-    return n;
-}
-static bool is_digit(char c) { return c >= '0' && c <= '9'; }
-static bool all_digits(const char* s, std::size_t n) {
-    for (std::size_t i = 0; i < n; ++i) if (!is_digit(s[i])) return false;
-    return true;
-}
-
-static bool parse_u32_field(const char* f, uint32_t& out) {
-    const std::size_t n = field_len(f);
-    if (n == 0) return false;
-
-    // Copy field into a small temp buffer so parsing can't run past the comma.
-    // (NMEA numeric fields are small; 16 is plenty for sats/fixq/hdop.)
-    char buf[16];
-    if (n >= sizeof(buf)) return false;
-
-    for (std::size_t i = 0; i < n; ++i) buf[i] = f[i];
-    buf[n] = '\0';
-
-    char* end = nullptr;
-    errno = 0;
-    long v = std::strtol(buf, &end, 10);
-
-    if (errno != 0 || end == buf || *end != '\0' || v < 0) return false;
-    out = (uint32_t)v;
-    return true;
-}
-
-static bool parse_float_field(const char* f, float& out) {
-    const std::size_t n = field_len(f);
-    if (n == 0) return false;
-
-    char buf[16];
-    if (n >= sizeof(buf)) return false;
-
-    for (std::size_t i = 0; i < n; ++i) buf[i] = f[i];
-    buf[n] = '\0';
-
-    char* end = nullptr;
-    errno = 0;
-    float v = std::strtof(buf, &end);
-
-    if (errno != 0 || end == buf || *end != '\0') return false;
-    out = v;
-    return true;
-}
-
-// Parses "hhmmss" or "hhmmss.sss" into h/m/s (seconds truncated)
-static bool parse_hhmmss(const char* s, int& hh, int& mm, int& ss) {
-    if (!s) return false;
-    // Need at least 6 digits
-    for (int i = 0; i < 6; ++i) if (!std::isdigit((unsigned char)s[i])) return false;
-
-    hh = (s[0]-'0')*10 + (s[1]-'0');
-    mm = (s[2]-'0')*10 + (s[3]-'0');
-    ss = (s[4]-'0')*10 + (s[5]-'0');
-
-    if (hh < 0 || hh > 23) return false;
-    if (mm < 0 || mm > 59) return false;
-    if (ss < 0 || ss > 60) return false; // allow leap second "60"
-    return true;
-}
-
-// Parses "ddmmyy" into Y/M/D (assumes 2000-2099 for yy 00-99)
-static bool parse_ddmmyy(const char* s, int& year, int& month, int& day) {
-    if (!s) return false;
-    for (int i = 0; i < 6; ++i) if (!std::isdigit((unsigned char)s[i])) return false;
-
-    day   = (s[0]-'0')*10 + (s[1]-'0');
-    month = (s[2]-'0')*10 + (s[3]-'0');
-    int yy = (s[4]-'0')*10 + (s[5]-'0');
-
-    // Common GPS assumption: 2000..2099
-    year = 2000 + yy;
-
-    if (month < 1 || month > 12) return false;
-    if (day < 1 || day > 31) return false;
-    return true;
-}
-
-static void copy_field(char* dst, size_t dst_size, const char* start) {
-    if (!dst || dst_size == 0) return;
-    if (!start) { dst[0] = '\0'; return; }
-
-    size_t i = 0;
-    while (start[i] && start[i] != ',' && start[i] != '*' && i < (dst_size - 1)) {
-        dst[i] = start[i];
-        ++i;
-    }
-    dst[i] = '\0';
+    // Newest edge passed the median/MAD interval filter, the filter has
+    // seen enough intervals, and PPS is still present (one missing pulse
+    // tolerated, as in the timebase).
+    return pps_stats_healthy(time_us_64(), 2500000ULL);
 }
 
-
 // Howard Hinnant's "days from civil" algorithm (public domain style)
 // Returns days since 1970-01-01.
 static int64_t days_from_civil(int y, unsigned m, unsigned d) {
@@ -158,249 +48,96 @@ static int64_t unix_seconds_utc(int year, int month, int day,
     return days * 86400 + hour * 3600 + minute * 60 + second;
 }
 
-void parse_rmc(const char* line) {
+void parse_rmc(const NmeaSentence& s) {
     // $GNRMC,hhmmss.sss,A/V,....,ddmmyy,...
     // field 1: time, field 2: status, field 9: date
+    const NmeaField& time   = s.at(1);
+    const NmeaField& status = s.at(2);
+    const NmeaField& date   = s.at(9);
 
-    if (!line) return;
-
-    const char* f1 = nullptr;  // time start
-    const char* f2 = nullptr;  // status start
-    const char* f9 = nullptr;  // date start
-
-    const char* e1 = nullptr;  // time end (comma or '*')
-    const char* e2 = nullptr;  // status end
-    const char* e9 = nullptr;  // date end
-
-    int field = 0; // 0 = talker+type, 1=time, 2=status, ...
-
-    // Field 0 begins at line[0]; field N begins right after the (N)th comma.
-    // We care about starts for 1,2,9 and their ends (next comma or '*').
-    for (const char* p = line; *p; ++p) {
-        if (*p == '*') {
-            // Sentence payload ends here; close any open field ends we care about.
-            if (f1 && !e1) e1 = p;
-            if (f2 && !e2) e2 = p;
-            if (f9 && !e9) e9 = p;
-            break;
-        }
-
-        if (*p == ',') {
-            // We just ended "field".
-            if (field == 1 && f1 && !e1) e1 = p;
-            else if (field == 2 && f2 && !e2) e2 = p;
-            else if (field == 9 && f9 && !e9) e9 = p;
-
-            ++field;
-
-            // Next field starts after this comma (may be empty).
-            const char* start = p + 1;
-            if (field == 1) f1 = start;
-            else if (field == 2) f2 = start;
-            else if (field == 9) f9 = start;
-        }
-    }
-
-    // If line ended without '*', close any still-open ends.
-    if (f1 && !e1) {
-        const char* p = f1;
-        while (*p && *p != ',' && *p != '*') ++p;
-        e1 = p;
-    }
-    if (f2 && !e2) {
-        const char* p = f2;
-        while (*p && *p != ',' && *p != '*') ++p;
-        e2 = p;
-    }
-    if (f9 && !e9) {
-        const char* p = f9;
-        while (*p && *p != ',' && *p != '*') ++p;
-        e9 = p;
-    }
-
-    auto field_nonempty = [](const char* s, const char* e) -> bool {
-        return s && e && (e > s) && (*s != '\0');
-    };
-
-    // Preserve raw strings for UI/status (optional but matches your current behavior).
-    if (field_nonempty(f1, e1)) copy_field(gps.last_rmc_time, sizeof(gps.last_rmc_time), f1);
-    if (field_nonempty(f9, e9)) copy_field(gps.last_rmc_date, sizeof(gps.last_rmc_date), f9);
+    int32_t ms_of_day = 0;
+    const bool time_ok = nmea_parse_time_ms(time, &ms_of_day);
+    if (time_ok) gps.rmc_time_ms = ms_of_day;
 
     // Status: only set if present; otherwise leave as-is (or set false if you prefer).
-    if (field_nonempty(f2, e2)) {
-        gps.rmc_valid = (f2[0] == 'A');
+    if (status.len) {
+        gps.rmc_valid = (status.p[0] == 'A');
     }
 
-    // Feed timebase only when status is 'A' and time+date exist.
-    if (!gps.rmc_valid) return;
-    if (!field_nonempty(f1, e1) || !field_nonempty(f9, e9)) return;
-
-    int hh, mm, ss;
-    int year, mon, day;
-
-    // parse_* operate on NUL-terminated strings, so use gps.* buffers (already copied)
-    // OR, if you want, add parse routines that accept (start,end).
-    if (parse_hhmmss(gps.last_rmc_time, hh, mm, ss) &&
-        parse_ddmmyy(gps.last_rmc_date, year, mon, day)) {
-
-        const int64_t unix_utc = unix_seconds_utc(year, mon, day, hh, mm, ss);
+    // Feed timebase only when status is 'A' and time+date exist, and only
+    // from the sentence for the top of the second: the timebase pairs it
+    // with the newest PPS edge, and at 5/10 Hz the N.800/N.900 sentences
+    // arrive after edge N+1 and would label it as second N.
+    if (!gps.rmc_valid || !time_ok || ms_of_day % 1000 != 0) return;
+
+    int32_t year, mon, day;
+    if (nmea_parse_ddmmyy(date, &year, &mon, &day)) {
+        const int sec_of_day = (int)(ms_of_day / 1000);
+        const int64_t unix_utc = unix_seconds_utc(year, mon, day,
+                                                  sec_of_day / 3600, (sec_of_day / 60) % 60,
+                                                  sec_of_day % 60);
         timebase_on_gps_utc_unix((uint64_t)unix_utc);
     }
 }
 
-void parse_gga(const char* line) {
+void parse_gga(const NmeaSentence& s) {
     // $GNGGA,time,lat,N,lon,W,fixQuality,numSats,hdop,...
-    if (!line) return;
-
-    const char* fixq = nullptr;
-    const char* sats = nullptr;
-    const char* hdop = nullptr;
-
-    const char* fixq_end = nullptr;
-    const char* sats_end = nullptr;
-    const char* hdop_end = nullptr;
-
-    int field = 0; // 0 = talker+type, 1=time, 2=lat, 3=N/S, 4=lon, 5=E/W, 6=fixq, 7=sats, 8=hdop...
-
-    for (const char* p = line; *p; ++p) {
-        if (*p == '*') {
-            if (fixq && !fixq_end) fixq_end = p;
-            if (sats && !sats_end) sats_end = p;
-            if (hdop && !hdop_end) hdop_end = p;
-            break;
-        }
-
-        if (*p == ',') {
-            // close the field we just finished
-            if (field == 6 && fixq && !fixq_end) fixq_end = p;
-            else if (field == 7 && sats && !sats_end) sats_end = p;
-            else if (field == 8 && hdop && !hdop_end) hdop_end = p;
-
-            ++field;
-
-            // next field starts after this comma
-            const char* start = p + 1;
-            if (field == 6) fixq = start;
-            else if (field == 7) sats = start;
-            else if (field == 8) hdop = start;
-        }
-    }
-
-    auto field_nonempty = [](const char* s, const char* e) -> bool {
-        return s && e && (e > s) && (*s != '\0');
-    };
+    const NmeaField& fixq = s.at(6);
+    const NmeaField& sats = s.at(7);
+    const NmeaField& hdop = s.at(8);
 
     // Fix quality is a single digit typically: 0 = invalid, 1 = GPS fix, 2 = DGPS, etc.
-    if (field_nonempty(fixq, fixq_end)) {
-        const char c = fixq[0];
-        gps.gga_fix = (c >= '1' && c <= '8'); // keep your existing rule
+    if (fixq.len) {
+        const char c = fixq.p[0];
+        gps.gga_fix = (c >= '1' && c <= '8'); // any fix type (0 = invalid)
         // If you want "any nonzero is a fix" instead: gps.gga_fix = (c != '0');
     }
 
-    if (field_nonempty(sats, sats_end)) {
-        uint32_t sats_u = 0;
-        if (parse_u32_field(sats, sats_u)) {
-            gps.sats = (int)sats_u;
-        }
-    }
-
-    if (field_nonempty(hdop, hdop_end)) {
-        float hdop_f = 0.0f;
-        if (parse_float_field(hdop, hdop_f)) {
-            gps.hdop = hdop_f;
-        }
+    uint32_t sats_u = 0;
+    if (nmea_parse_u32(sats, &sats_u)) {
+        gps.sats = (int)sats_u;
     }
-}
-
-void parse_zda(const char* line) {
-    // $GNZDA,hhmmss.sss,dd,mm,yyyy,...
-    if (!line) return;
-
-    const char* f_time = nullptr;
-    const char* f_dd   = nullptr;
-    const char* f_mm   = nullptr;
-    const char* f_yyyy = nullptr;
-
-    const char* e_time = nullptr;
-    const char* e_dd   = nullptr;
-    const char* e_mm   = nullptr;
-    const char* e_yyyy = nullptr;
 
-    int field = 0; // 0=talker+type, 1=time, 2=dd, 3=mm, 4=yyyy, ...
-
-    for (const char* p = line; *p; ++p) {
-        if (*p == '*') {
-            if (f_time && !e_time) e_time = p;
-            if (f_dd   && !e_dd)   e_dd   = p;
-            if (f_mm   && !e_mm)   e_mm   = p;
-            if (f_yyyy && !e_yyyy) e_yyyy = p;
-            break;
-        }
-
-        if (*p == ',') {
-            // close the field we just ended
-            if (field == 1 && f_time && !e_time) e_time = p;
-            else if (field == 2 && f_dd && !e_dd) e_dd = p;
-            else if (field == 3 && f_mm && !e_mm) e_mm = p;
-            else if (field == 4 && f_yyyy && !e_yyyy) e_yyyy = p;
-
-            ++field;
-
-            // next field starts after this comma
-            const char* start = p + 1;
-            if (field == 1) f_time = start;
-            else if (field == 2) f_dd = start;
-            else if (field == 3) f_mm = start;
-            else if (field == 4) f_yyyy = start;
-        }
+    int32_t hdop_centi = 0;
+    if (nmea_parse_fixed(hdop, 2, &hdop_centi)) {
+        gps.hdop_centi = hdop_centi;
     }
 
-    auto field_nonempty = [](const char* s, const char* e) -> bool {
-        return s && e && (e > s) && (*s != '\0');
-    };
-
-    if (!field_nonempty(f_time, e_time) ||
-        !field_nonempty(f_dd,   e_dd)   ||
-        !field_nonempty(f_mm,   e_mm)   ||
-        !field_nonempty(f_yyyy, e_yyyy)) {
-        return;
+    int32_t lat = 0, lon = 0;
+    if (gps.gga_fix &&
+        nmea_parse_coord(s.at(2), s.at(3), &lat) &&
+        nmea_parse_coord(s.at(4), s.at(5), &lon)) {
+        gps.lat_udeg = lat;
+        gps.lon_udeg = lon;
+        gps.have_position = true;
+    } else {
+        gps.have_position = false;
     }
+}
 
-    // Validate minimum lengths and digit content
-    // NOTE: We only need the first 6 digits of time and exact digits for dd/mm/yyyy.
-    if ((e_time - f_time) < 6 || !all_digits(f_time, 6)) return;  // hhmmss...
-    if ((e_dd   - f_dd)   < 2 || !all_digits(f_dd,   2)) return;  // dd
-    if ((e_mm   - f_mm)   < 2 || !all_digits(f_mm,   2)) return;  // mm
-    if ((e_yyyy - f_yyyy) < 4 || !all_digits(f_yyyy, 4)) return;  // yyyy
+void parse_zda(const NmeaSentence& s) {
+    // $GNZDA,hhmmss.sss,dd,mm,yyyy,...
+    int32_t ms_of_day = 0;
+    uint32_t dd = 0, mm = 0, yyyy = 0;
 
-    // Optional: range checks (cheap, prevents nonsense)
-    const int hh_i = (f_time[0]-'0')*10 + (f_time[1]-'0');
-    const int mm_i = (f_time[2]-'0')*10 + (f_time[3]-'0');
-    const int ss_i = (f_time[4]-'0')*10 + (f_time[5]-'0');
-    const int dd_i = (f_dd[0]-'0')*10   + (f_dd[1]-'0');
-    const int mo_i = (f_mm[0]-'0')*10   + (f_mm[1]-'0');
+    if (!nmea_parse_time_ms(s.at(1), &ms_of_day)) return;
+    if (s.at(2).len != 2 || !nmea_parse_u32(s.at(2), &dd)) return;
+    if (s.at(3).len != 2 || !nmea_parse_u32(s.at(3), &mm)) return;
+    if (s.at(4).len != 4 || !nmea_parse_u32(s.at(4), &yyyy)) return;
 
-    if (hh_i > 23) return;
-    if (mm_i > 59) return;
-    if (ss_i > 60) return; // allow leap second
-    if (mo_i < 1 || mo_i > 12) return;
-    if (dd_i < 1 || dd_i > 31) return;
+    // Range checks (cheap, prevents nonsense)
+    if (mm < 1 || mm > 12) return;
+    if (dd < 1 || dd > 31) return;
 
-    // Format: YYYY-MM-DD HH:MM:SSZ
-    // Use direct chars to avoid temp buffers.
-    snprintf(gps.last_zda, sizeof(gps.last_zda),
-             "%c%c%c%c-%c%c-%c%c %c%c:%c%c:%c%cZ",
-             f_yyyy[0], f_yyyy[1], f_yyyy[2], f_yyyy[3],
-             f_mm[0],   f_mm[1],
-             f_dd[0],   f_dd[1],
-             f_time[0], f_time[1],
-             f_time[2], f_time[3],
-             f_time[4], f_time[5]);
+    gps.zda_time_ms = ms_of_day;
+    gps.zda_year    = (int16_t)yyyy;
+    gps.zda_month   = (int8_t)mm;
+    gps.zda_day     = (int8_t)dd;
 }
 
 void gps_state_service()
 {
-    // Your pre-PPS notion of acquired:
+    // Acquired: valid RMC and a GGA fix, PPS or not
     const bool acquired = (gps.rmc_valid && gps.gga_fix);
 
     if (!acquired) {
@@ -413,27 +150,53 @@ void gps_state_service()
                                    : GPSDeviceState::Acquired;
 }
 
+// Sentence types we act on (any talker: GP, GN, GL, ...)
+struct SentenceHandler {
+    const char* type;
+    void (*parse)(const NmeaSentence& s);
+};
+
+static const SentenceHandler k_handlers[] = {
+    {"RMC", parse_rmc},
+    {"GGA", parse_gga},
+    {"ZDA", parse_zda},
+};
+
+// Handler for the sentence's type, read straight from "$ttTTT," so the
+// types we ignore (GSV, GSA, VTG, GLL: most of each second's output) are
+// dropped before the checksum walk.
+static const SentenceHandler* find_handler(const char* line) {
+    if (!line[1] || !line[2]) return nullptr;
+    for (const SentenceHandler& h : k_handlers) {
+        if (line[3] == h.type[0] && line[4] == h.type[1] && line[5] == h.type[2] &&
+            line[6] == ',') {
+            return &h;
+        }
+    }
+    return nullptr;
+}
+
 void update_from_nmea(const char* line) {
     if (!line || line[0] != '$') return;
 
-    bool handled = false;
+    const SentenceHandler* h = find_handler(line);
+    if (!h) return;
 
-    // Accept any talker: $??RMC, $??GGA, $??ZDA
-    if (starts_with(line + 3, "RMC,")) {
-        parse_rmc(line);
-        handled = true;
-    } else if (starts_with(line + 3, "GGA,")) {
-        parse_gga(line);
-        handled = true;
-    } else if (starts_with(line + 3, "ZDA,")) {
-        parse_zda(line);
-        handled = true;
+    // Checksum is verified here, so a corrupted RMC never reaches the timebase.
+    NmeaSentence s;
+    if (nmea_tokenize(line, &s) != NmeaResult::Ok) {
+        gps.nmea_rejected++;
+        return;
     }
+    gps.nmea_ok++;
 
-    if (!handled) return;
+    h->parse(s);
 
+    g_gps_view.publish(gps);
     gps_state_service();
-    // // Current “no PPS yet” notion of acquired:
-    // g_state = (gps.rmc_valid && gps.gga_fix) ? GPSDeviceState::Acquired
-    //                                         : GPSDeviceState::Acquiring;
+}
+
+void gps_state_get_status(GpsStatus* out) {
+    if (!out) return;
+    if (!g_gps_view.read(out)) *out = GpsStatus{};
 }
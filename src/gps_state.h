@@ -12,12 +12,9 @@
  */
 #pragma once
 #include <cstdint>
-#include <cerrno>   // errno
-#include <cstdlib>  // strtol, strtof
 #include <cstddef>  // std::size_t
-#include <cstdio>   // snprintf
-#include <cstdlib>  // atoi, atof
-#include <cctype>
+
+#include "nmea.h"
 
 enum class GPSDeviceState : uint8_t 
 { 
@@ -40,22 +37,37 @@ inline const char* state_str(GPSDeviceState s) {
     return "?";
 }
 
+// Parsed values only (fixed point, no floats or raw strings); -1 = not seen yet.
 struct GpsStatus {
     bool rmc_valid = false;
     bool gga_fix = false;
     int  sats = -1;
-    float hdop = -1.0f;
-    char last_rmc_time[16] = ""; // hhmmss.sss
-    char last_rmc_date[16] = ""; // ddmmyy
-    char last_zda[32] = "";      // dd-mm-yyyy hh:mm:ss
+    int32_t hdop_centi = -1;     // HDOP x 100
+
+    int32_t rmc_time_ms = -1;    // UTC ms of day from the last RMC
+
+    int32_t zda_time_ms = -1;    // UTC ms of day from the last ZDA
+    int16_t zda_year  = 0;
+    int8_t  zda_month = 0;
+    int8_t  zda_day   = 0;
+
+    bool    have_position = false;  // from GGA
+    int32_t lat_udeg = 0;           // micro-degrees, + = N
+    int32_t lon_udeg = 0;           // micro-degrees, + = E
+
+    uint32_t nmea_ok       = 0;  // RMC/GGA/ZDA with a valid checksum
+    uint32_t nmea_rejected = 0;  // RMC/GGA/ZDA with a missing/bad checksum or malformed
 };
 
-void parse_rmc(const char* line);
-void parse_gga(const char* line);
-void parse_zda(const char* line);
+void parse_rmc(const NmeaSentence& s);
+void parse_gga(const NmeaSentence& s);
+void parse_zda(const NmeaSentence& s);
 void update_from_nmea(const char* line);
 void gps_state_service();
 
+// Tear-free copy of `gps`, for readers that may run on the other core.
+void gps_state_get_status(GpsStatus* out);
+
 extern volatile GPSDeviceState g_state;
 extern GpsStatus gps;
 
@@ -0,0 +1,121 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "gps_task.h"
+
+#include "gps_uart.h"
+#include "gps_state.h"
+#include "pps.h"
+#include "pps_out.h"
+#include "pps_stats.h"
+#include "timebase.h"
+#include "core_load.h"
+#include "temp.h"
+
+#if NTP_MULTICORE
+#include <cstdio>
+
+#include "hardware/timer.h"
+#include "pico/multicore.h"
+#include "pico/time.h"
+#endif
+
+void gps_task_init()
+{
+    GpsUart::init(9600, /*rx_gpio=*/1, /*tx_gpio=*/0);
+    pps_init(16);
+    pps_stats_init();
+    pps_out_init();
+
+    // The timebase's temperature model reads the sensor from this loop.
+    temp_init();
+}
+
+void gps_task_poll()
+{
+    // Classify new edges before an RMC below pairs one with its second.
+    pps_stats_service();
+
+    GpsLineView v{};
+    while (GpsUart::next_line(&v)) {
+#if GPS_UART_DMA
+        // The DMA doesn't wait for us and may overwrite a line after its
+        // checksum was verified. Parse a copy, and only if the line was
+        // still intact once it had been copied.
+        char line[GPS_LINE_MAX + 1];
+        gps_line_copy(&v, line, sizeof(line));
+        if (GpsUart::release_line()) update_from_nmea(line);
+#else
+        if (v.len[1] == 0) {
+            // Common case: parse straight out of the receive ring (the RX
+            // IRQ drops bytes rather than overwrite an unreleased line).
+            update_from_nmea(v.seg[0]);
+        } else {
+            // Wrapped around the end of the ring (once per 2 KiB)
+            char line[GPS_LINE_MAX + 1];
+            gps_line_copy(&v, line, sizeof(line));
+            update_from_nmea(line);
+        }
+        GpsUart::release_line();
+#endif
+    }
+
+    gps_state_service();
+
+    temp_service();
+    timebase_service();
+    pps_out_service();
+}
+
+#if NTP_MULTICORE
+
+// Core1 sleeps between UART/PPS interrupts; something must keep
+// timebase_service() and gps_state_service() running if the GPS goes quiet.
+// In DMA mode GpsUart's poll alarm already wakes this core every 20 ms, so
+// only the IRQ-mode UART needs an alarm of its own. A spare one matters:
+// the RP2040 has four, the default pool holds one and PPS_OUT takes two.
+#if !GPS_UART_DMA
+static constexpr uint32_t CORE1_WAKE_MS = 100;
+
+static void core1_wake_cb(unsigned alarm_num)
+{
+    hardware_alarm_set_target(alarm_num, make_timeout_time_ms(CORE1_WAKE_MS));
+}
+#endif
+
+static void core1_main()
+{
+    gps_task_init();
+
+#if !GPS_UART_DMA
+    // Claimed here so the wake-up IRQ is taken on this core.
+    const int wake = hardware_alarm_claim_unused(false);
+    if (wake >= 0) {
+        hardware_alarm_set_callback(wake, &core1_wake_cb);
+        hardware_alarm_set_target(wake, make_timeout_time_ms(CORE1_WAKE_MS));
+    } else {
+        std::printf("core1: no free hardware alarm, woken by UART/PPS IRQs only\r\n");
+    }
+#endif
+
+    while (true) {
+        gps_task_poll();
+        core_load_idle();
+    }
+}
+
+void gps_task_launch_core1()
+{
+    multicore_launch_core1(core1_main);
+}
+
+#endif // NTP_MULTICORE
@@ -0,0 +1,31 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+// GPS side of the firmware: UART/NMEA, PPS capture, the temperature sensor
+// and timebase discipline.
+// Runs from the main loop, or owns core1 when built with NTP_MULTICORE; it
+// shares data with the network/UI side only through lock-free snapshots
+// (timebase, gps_state_get_status()) and single-word counters.
+
+// GpsUart + PPS IRQ (registered on the calling core) and the ADC.
+void gps_task_init();
+
+// Drain complete NMEA lines, update GPS state, sample the temperature,
+// keep the timebase fresh.
+void gps_task_poll();
+
+#if NTP_MULTICORE
+// Start core1 running gps_task_init() and then gps_task_poll() forever.
+void gps_task_launch_core1();
+#endif
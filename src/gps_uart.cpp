@@ -15,13 +15,32 @@
 #include "hardware/uart.h"
 #include "hardware/irq.h"
 #include "hardware/gpio.h"
+#include "hardware/timer.h"
+#if GPS_UART_DMA
+#include "hardware/dma.h"
+#endif
 #include <cstdio>
 
 // ---- Static storage definitions (exactly once) ----
 volatile uint32_t GpsUart::head = 0;
 volatile uint32_t GpsUart::tail = 0;
 volatile uint32_t GpsUart::rb_overflow_count = 0;
+volatile uint32_t GpsUart::irq_count = 0;
+volatile uint32_t GpsUart::irq_time_us = 0;
+uint32_t GpsUart::scan = 0;
+bool GpsUart::pending = false;
+uint32_t GpsUart::pending_next = 0;
+GpsLineView GpsUart::pending_view{};
+uint32_t GpsUart::line_count = 0;
+uint32_t GpsUart::truncated_count = 0;
+#if GPS_UART_DMA
+alignas(GpsUart::RB_SIZE) uint8_t GpsUart::rb[GpsUart::RB_SIZE] = {0};
+int GpsUart::dma_chan = -1;
+int GpsUart::poll_alarm = -1;
+volatile uint32_t GpsUart::dma_base = 0;
+#else
 uint8_t GpsUart::rb[GpsUart::RB_SIZE] = {0};
+#endif
 // ---------------------------------------------------
 
 void GpsUart::init(uint32_t baud, uint32_t rx_gpio, uint32_t tx_gpio) {
@@ -29,6 +48,12 @@ void GpsUart::init(uint32_t baud, uint32_t rx_gpio, uint32_t tx_gpio) {
     head = 0;
     tail = 0;
     rb_overflow_count = 0;
+    irq_count = 0;
+    irq_time_us = 0;
+    scan = 0;
+    pending = false;
+    line_count = 0;
+    truncated_count = 0;
 
     printf("Initializing GPS UART...\r\n");
 
@@ -41,66 +66,236 @@ void GpsUart::init(uint32_t baud, uint32_t rx_gpio, uint32_t tx_gpio) {
     uart_set_hw_flow(uart0, false, false);
     uart_set_fifo_enabled(uart0, true);
 
+#if GPS_UART_DMA
+    // No UART interrupts: the DMA drains the RX FIFO (uart_init enables DREQs).
+    uart_set_irq_enables(uart0, false, false);
+
+    dma_base = 0;
+    dma_chan = dma_claim_unused_channel(true);
+
+    dma_channel_config c = dma_channel_get_default_config(dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, /*write=*/true, RB_BITS);
+    channel_config_set_dreq(&c, uart_get_dreq(uart0, /*is_tx=*/false));
+    dma_channel_configure(dma_chan, &c, rb, &uart_get_hw(uart0)->dr, DMA_BLOCK, false);
+
+    // IRQs are taken on the calling core, which must also be the consumer.
+    irq_add_shared_handler(DMA_IRQ_1, &GpsUart::dma_irq_handler,
+                           PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    dma_channel_set_irq1_enabled(dma_chan, true);
+    irq_set_enabled(DMA_IRQ_1, true);
+
+    dma_channel_start(dma_chan);
+
+    poll_alarm = hardware_alarm_claim_unused(true);
+    hardware_alarm_set_callback(poll_alarm, &GpsUart::poll_alarm_cb);
+    hardware_alarm_set_target(poll_alarm, make_timeout_time_ms(DMA_POLL_MS));
+#else
     // Install IRQ handler (no lambda)
     irq_set_exclusive_handler(UART0_IRQ, &GpsUart::uart0_irq_handler);
     irq_set_enabled(UART0_IRQ, true);
 
     // Enable RX IRQ
     uart_set_irq_enables(uart0, true, false);
+#endif
+}
+
+#if GPS_UART_DMA
+
+void GpsUart::dma_irq_handler() {
+    if (!dma_channel_get_irq1_status(dma_chan)) return;
+
+    const uint32_t t0 = time_us_32();
+    dma_channel_acknowledge_irq1(dma_chan);
+
+    // Block finished (every 2^30 bytes): account for it and keep going. The
+    // write address carries on around the ring.
+    dma_base = dma_base + DMA_BLOCK;
+    dma_channel_set_trans_count(dma_chan, DMA_BLOCK, true);
+
+    irq_count = irq_count + 1u;
+    irq_time_us = irq_time_us + (time_us_32() - t0);
+}
+
+// Consumer "timeout": does nothing but end the core's WFI so get_line() runs.
+void GpsUart::poll_alarm_cb(unsigned alarm_num) {
+    const uint32_t t0 = time_us_32();
+    hardware_alarm_set_target(alarm_num, make_timeout_time_ms(DMA_POLL_MS));
+
+    irq_count = irq_count + 1u;
+    irq_time_us = irq_time_us + (time_us_32() - t0);
+}
+
+// The DMA IRQ runs on the consumer's core, so a changed dma_base just means
+// it preempted this read; retry.
+uint32_t GpsUart::produced() {
+    uint32_t base = 0, remaining = 0;
+    do {
+        base = dma_base;
+        remaining = dma_channel_hw_addr(dma_chan)->transfer_count;
+    } while (base != dma_base);
+    return base + (DMA_BLOCK - remaining);
 }
 
+#else
+
 void GpsUart::uart0_irq_handler() {
+    const uint32_t t0 = time_us_32();
     GpsUart::on_uart_rx();
+
+    irq_count = irq_count + 1u;
+    irq_time_us = irq_time_us + (time_us_32() - t0);
 }
 
 void GpsUart::on_uart_rx() {
     while (uart_is_readable(uart0)) {
         uint8_t c = (uint8_t)uart_getc(uart0);
-        uint32_t next = (head + 1u) & RB_MASK;
-        if (next != tail) {
-            rb[head] = c;
-            head = next;
+        if (head - tail < RB_SIZE) {
+            rb[head & RB_MASK] = c;
+            head = head + 1u;
         } else {
             rb_overflow_count++;
         }
     }
 }
 
-bool GpsUart::get_line(char* out, size_t out_cap) {
-    if (!out || out_cap < 2) return false;
+uint32_t GpsUart::produced() {
+    return head;
+}
+
+#endif
+
+void GpsUart::skip_to(uint32_t pos) {
+    tail = pos;
+    scan = pos;
+}
 
-    // Snapshot head so we have a stable "available bytes" boundary for this call.
-    const uint32_t h = head;
-    const uint32_t t0 = tail;
+bool GpsUart::next_line(GpsLineView* out) {
+    if (!out) return false;
+    if (pending) {
+        *out = pending_view;
+        return true;
+    }
 
-    if (t0 == h) return false; // empty
+    const uint32_t h = produced();
+    uint32_t t = tail;
 
-    uint32_t probe = t0;
-    size_t len = 0;
-    bool truncated = false;
+#if GPS_UART_DMA
+    // The DMA never waits for us: if it lapped the reader, the unread bytes
+    // are gone. Drop them and resync on the next line.
+    if (h - t > RB_SIZE) {
+        rb_overflow_count += h - t;
+        skip_to(h);
+        return false;
+    }
+#endif
 
-    while (probe != h) {
-        const uint8_t c = rb[probe];
-        probe = (probe + 1u) & RB_MASK;
+    // Resume the '\n' search where the last call stopped.
+    uint32_t s = scan;
+    if (s - t > h - t) s = t;
 
-        if (c == '\r') continue;
+    for (; s != h; ++s) {
+        if (rb[s & RB_MASK] != '\n') continue;
 
-        if (c == '\n') {
-            // We found a complete line; now we can commit consumption.
-            out[len] = '\0';
-            tail = probe; // consume through '\n'
-            (void)truncated; // available if you want to count/report truncations
-            return true;
+        uint32_t end = s;
+        if (end != t && rb[(end - 1u) & RB_MASK] == '\r') end--;
+
+        const uint32_t len = end - t;
+        if (len > GPS_LINE_MAX) {
+            truncated_count++;
+            skip_to(s + 1u);
+            t = s + 1u;
+            continue;
         }
 
-        if (len < (out_cap - 1)) {
-            out[len++] = (char)c;
-        } else {
-            truncated = true; // keep consuming until newline, but stop writing
+        // Terminate in place over the CR/LF (already received, so the
+        // producer is past it).
+        rb[end & RB_MASK] = '\0';
+
+        const uint32_t first = t & RB_MASK;
+        const uint32_t len0  = (len < RB_SIZE - first) ? len : (RB_SIZE - first);
+
+        GpsLineView v{};
+        v.seg[0] = reinterpret_cast<const char*>(&rb[first]);
+        v.len[0] = len0;
+        if (len0 < len) {
+            v.seg[1] = reinterpret_cast<const char*>(&rb[0]);
+            v.len[1] = len - len0;
         }
+
+        scan = s;
+        pending = true;
+        pending_next = s + 1u;
+        pending_view = v;
+        line_count++;
+
+        *out = v;
+        return true;
     }
 
-    // No newline yet -> do not consume anything.
+    // No newline yet. A partial line this long will never fit: drop it.
+    if (h - t > GPS_LINE_MAX + 2u) {
+        truncated_count++;
+        skip_to(h);
+        return false;
+    }
+
+    scan = s;
     return false;
 }
 
+bool GpsUart::release_line() {
+    if (!pending) return false;
+
+    const uint32_t start = tail;
+    pending = false;
+    tail = pending_next;
+    scan = pending_next;
+
+#if GPS_UART_DMA
+    // Overwritten while the caller was using it?
+    if (produced() - start > RB_SIZE) {
+        rb_overflow_count += pending_next - start;
+        return false;
+    }
+#else
+    (void)start;
+#endif
+    return true;
+}
+
+bool GpsUart::get_line(char* out, size_t out_cap) {
+    if (!out || out_cap < 2) return false;
+
+    GpsLineView v{};
+    if (!next_line(&v)) return false;
+
+    if (v.size() >= out_cap) truncated_count++;
+    gps_line_copy(&v, out, out_cap);
+    return release_line();
+}
+
+size_t gps_line_copy(const GpsLineView* v, char* out, size_t out_cap) {
+    if (!v || !out || out_cap == 0) return 0;
+
+    size_t n = 0;
+    for (uint32_t i = 0; i < 2; ++i) {
+        for (uint32_t j = 0; j < v->len[i] && n < out_cap - 1; ++j) out[n++] = v->seg[i][j];
+    }
+    out[n] = '\0';
+    return n;
+}
+
+void GpsUart::get_stats(GpsUartStats* out) {
+    if (!out) return;
+
+    out->dma      = (GPS_UART_DMA != 0);
+    out->bytes    = produced();
+    out->lines    = line_count;
+    out->truncated = truncated_count;
+    out->overflow = rb_overflow_count;
+    out->irqs     = irq_count;
+    out->irq_us   = irq_time_us;
+}
@@ -14,20 +14,100 @@
 #include <cstddef>
 #include <cstdint>
 
+// 1: DMA ring receive (set by CMake option GPS_UART_DMA), 0: per-FIFO IRQ drain
+#ifndef GPS_UART_DMA
+#define GPS_UART_DMA 0
+#endif
+
+// Receive statistics. Counters are cumulative; the UI turns them into rates.
+struct GpsUartStats {
+    bool     dma      = false;  // built with GPS_UART_DMA
+    uint32_t bytes    = 0;      // bytes received from the UART
+    uint32_t lines    = 0;      // complete lines handed out
+    uint32_t truncated = 0;     // lines dropped for exceeding GPS_LINE_MAX
+    uint32_t overflow = 0;      // bytes lost because the ring was full
+    uint32_t irqs     = 0;      // interrupts taken by the receive path
+    uint32_t irq_us   = 0;      // time spent in those handlers
+};
+
+// Longest line handed out (NMEA allows 82; leave room for proprietary ones)
+constexpr uint32_t GPS_LINE_MAX = 255;
+
+// A received line, CR/LF stripped, viewed in place in the receive ring: one
+// span, or two when it wraps. The byte after the last span is '\0', so a
+// one-span line is also a C string. Valid until GpsUart::release_line().
+struct GpsLineView {
+    const char* seg[2] = {nullptr, nullptr};
+    uint32_t    len[2] = {0, 0};
+
+    uint32_t size() const { return len[0] + len[1]; }
+};
+
+// Copy a view into out as a C string (truncating to out_cap - 1). Returns the length copied.
+size_t gps_line_copy(const GpsLineView* v, char* out, size_t out_cap);
+
 class GpsUart {
 public:
     static void init(uint32_t baud = 9600, uint32_t rx_gpio = 1, uint32_t tx_gpio = 0);
+
+    // Zero-copy: next complete line, or false if none yet. Each byte is
+    // scanned once however often this is polled. Calling it again before
+    // release_line() returns the same line.
+    static bool next_line(GpsLineView* out);
+    // Consume the line from next_line(). Returns false if (DMA mode) the
+    // receiver overwrote it while it was in use.
+    static bool release_line();
+
+    // Copying convenience wrapper over next_line()/release_line().
     static bool get_line(char* out, size_t out_cap);
+    static void get_stats(GpsUartStats* out);
 
 private:
-    static inline constexpr uint32_t RB_SIZE = 2048;
+    static inline constexpr uint32_t RB_BITS = 11;
+    static inline constexpr uint32_t RB_SIZE = 1u << RB_BITS;
     static inline constexpr uint32_t RB_MASK = RB_SIZE - 1;
     static_assert((RB_SIZE & RB_MASK) == 0, "RB_SIZE must be power of two");
 
     // Storage (declare here, define once in gps_uart.cpp)
+    // head/tail are free-running byte counts; the ring index is x & RB_MASK.
     static volatile uint32_t head;
     static volatile uint32_t tail;
     static volatile uint32_t rb_overflow_count;
+    static volatile uint32_t irq_count;
+    static volatile uint32_t irq_time_us;
+
+    // Consumer-only state: how far past tail has been searched for '\n',
+    // and the line currently handed out.
+    static uint32_t scan;
+    static bool pending;
+    static uint32_t pending_next;        // tail after release
+    static GpsLineView pending_view;
+    static uint32_t line_count;
+    static uint32_t truncated_count;
+
+    // Drop everything received so far (after an overrun or an over-long line).
+    static void skip_to(uint32_t pos);
+
+    // Current producer position (bytes ever written to rb)
+    static uint32_t produced();
+
+#if GPS_UART_DMA
+    // The DMA write ring wraps on an RB_SIZE boundary.
+    alignas(RB_SIZE) static uint8_t rb[RB_SIZE];
+
+    // A DMA channel writes into rb as a ring; `head` is derived from its
+    // transfer count. Transfer blocks are huge, so the completion IRQ is
+    // only a rare re-arm; a periodic alarm just wakes the consumer.
+    static inline constexpr uint32_t DMA_BLOCK   = 1u << 30;
+    static inline constexpr uint32_t DMA_POLL_MS = 20;
+
+    static int dma_chan;
+    static int poll_alarm;
+    static volatile uint32_t dma_base;   // bytes from completed blocks
+
+    static void dma_irq_handler();
+    static void poll_alarm_cb(unsigned alarm_num);
+#else
     static uint8_t rb[RB_SIZE];
 
     // IRQ entrypoint Pico SDK expects (plain function pointer)
@@ -35,4 +115,5 @@ private:
 
     // Internal RX drain
     static void on_uart_rx();
+#endif
 };
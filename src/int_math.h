@@ -0,0 +1,50 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <cstdint>
+
+// Integer helpers shared by the servo, timebase, PPS capture and statistics
+// (no FPU and no 64-bit divider on the RP2040).
+
+// |v| for offsets and intervals; INT64_MIN never occurs there.
+inline int64_t abs64(int64_t v) { return v < 0 ? -v : v; }
+
+// floor(sqrt(v)), one result bit per iteration
+inline uint64_t isqrt64(uint64_t v) {
+    uint64_t r = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return r;
+}
+
+// nsec / 1000 == (nsec * ceil(2^40 / 1000)) >> 40, exact for nsec < 1e9
+inline uint32_t nsec_to_usec(uint32_t nsec) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(nsec) * 1099511628ULL) >> 40);
+}
+
+// floor(a * q / 2^32) for a Q32 factor q, from 32x32 partial products;
+// a * (q >> 32) and (a >> 32) * (q & 0xFFFFFFFF) must each fit in 64 bits.
+inline uint64_t mul_q32(uint64_t a, uint64_t q) {
+    const uint64_t a_lo = a & 0xFFFFFFFFu;
+    const uint64_t q_lo = q & 0xFFFFFFFFu;
+    return a * (q >> 32) + (a >> 32) * q_lo + ((a_lo * q_lo) >> 32);
+}
@@ -0,0 +1,46 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <cstdint>
+
+// Header-only log2 latency histogram (microseconds). Bin 0 holds 0 us,
+// bin i holds [2^(i-1), 2^i) us, the last bin is open-ended. Cheap enough
+// to update per packet from IRQ context; readers may see a torn snapshot.
+
+constexpr uint32_t LATENCY_HIST_BINS = 20;   // last bin starts at ~262 ms
+
+struct LatencyHist {
+    uint32_t bins[LATENCY_HIST_BINS] = {};
+    uint32_t count  = 0;
+    uint32_t max_us = 0;
+};
+
+inline void hist_add(LatencyHist* h, uint32_t us) {
+    uint32_t bin = 0;
+    while (us >> bin && bin < LATENCY_HIST_BINS - 1) ++bin;
+    h->bins[bin]++;
+    h->count++;
+    if (us > h->max_us) h->max_us = us;
+}
+
+// Upper edge (us) of the bin containing the pct-th percentile; 0 if empty.
+inline uint32_t hist_percentile_us(const LatencyHist* h, uint32_t pct) {
+    if (h->count == 0) return 0;
+    const uint64_t want = (static_cast<uint64_t>(h->count) * pct + 99u) / 100u;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < LATENCY_HIST_BINS; ++i) {
+        seen += h->bins[i];
+        if (seen >= want) return (i == LATENCY_HIST_BINS - 1) ? h->max_us : (1u << i);
+    }
+    return h->max_us;
+}
@@ -61,6 +61,26 @@
 #define LWIP_NETCONN                   0
 #define LWIP_SOCKET                    0
 
+// --- RX timestamp carried with each pbuf ---
+// Stamped with time_us_64() as the frame is handed to the netif input path
+// (see ntp_server.cpp), so NTP T2 reflects arrival rather than processing.
+#define LWIP_PBUF_CUSTOM_DATA          uint64_t rx_local_us;
+#define LWIP_PBUF_CUSTOM_DATA_INIT(p)  do { (p)->rx_local_us = 0; } while (0)
+
+// --- NTP early-demux fast path ---
+// 1: UDP/123 client requests are answered from LWIP_HOOK_IP4_INPUT, skipping
+// the UDP PCB lookup; anything unusual still reaches udp_recv (ntp_server.cpp).
+// 0: every request goes through on_ntp_rx(). Set from CMake (NTP_FAST_PATH,
+// off until the NTP_BENCH ip4_input numbers show it pays off).
+#ifndef NTP_FAST_PATH
+#define NTP_FAST_PATH                  0
+#endif
+
+#if NTP_FAST_PATH
+#define LWIP_HOOK_FILENAME             "ntp_fast_path.h"
+#define LWIP_HOOK_IP4_INPUT(p, inp)    ntp_fast_path_ip4_input((p), (inp))
+#endif
+
 // --- Debug (off by default) ---
 #define LWIP_DEBUG                     0
 
@@ -16,11 +16,11 @@
 #include <cstring>
 #include <cstdlib>
 
-#include "gps_uart.h"
+#include "gps_task.h"
+#include "core_load.h"
 #include "led.h"
 #include "gps_state.h"
 #include "ui_console.h"
-#include "temp.h"
 #include "uptime.h"
 
 #include "wifi_secrets.h"
@@ -32,6 +32,10 @@
 #include "hardware/timer.h"
 #include "pps.h"
 
+#if NTP_BENCH
+#include "bench.h"
+#endif
+
 // Pico W only
 #ifdef CYW43_WL_GPIO_LED_PIN
 #include "pico/cyw43_arch.h"
@@ -67,15 +71,6 @@ static void setup_led(repeating_timer_t &timer)
     add_repeating_timer_ms(50, pulse_cb, (void*)&g_state, &timer);
 }
 
-static void handle_nmea()
-{
-    char line[256];
-    while (GpsUart::get_line(line, sizeof(line))) {
-        // printf(".");
-        update_from_nmea(line);
-    }
-}
-
 static void redraw_dashboard(absolute_time_t &next_ui)
 {
     if (absolute_time_diff_us(get_absolute_time(), next_ui) <= 0) {
@@ -84,6 +79,19 @@ static void redraw_dashboard(absolute_time_t &next_ui)
     }
 }
 
+// 'a' on the console dumps the stability table as CSV; the dashboard then
+// stays off this long so it can be copied or captured.
+static constexpr uint32_t STABILITY_DUMP_HOLD_MS = 30000;
+
+static void poll_console_keys(absolute_time_t &next_ui)
+{
+    const int c = getchar_timeout_us(0);
+    if (c == 'a' || c == 'A') {
+        dashboard_dump_stability();
+        next_ui = make_timeout_time_ms(STABILITY_DUMP_HOLD_MS);
+    }
+}
+
 int main() {
     repeating_timer_t timer;
     absolute_time_t next_ui = make_timeout_time_ms(500);
@@ -107,7 +115,6 @@ int main() {
     printf("\x1b[?25l"); // hide cursor
     printf("PICO NTPServer starting...\r\n");
 
-    temp_init();
     uptime_init();
     timebase_init();
 
@@ -121,20 +128,32 @@ int main() {
     setup_led(timer);
 
 
-    GpsUart::init(9600, /*rx_gpio=*/1, /*tx_gpio=*/0);
-    pps_init(16);
+#if NTP_MULTICORE
+    // Core1: GPS UART, NMEA, PPS IRQ, timebase. Core0 keeps lwIP/NTP and the UI.
+    gps_task_launch_core1();
+#else
+    gps_task_init();
+#endif
+
+#if NTP_BENCH
+    // One-shot hot-path timings, before the dashboard takes over the console
+    bench_run_all();
+    sleep_ms(5000);
+#endif
 
     while (true) {
         // printf(".");
-        handle_nmea();
-
-        gps_state_service();
+#if !NTP_MULTICORE
+        gps_task_poll();
+#endif
 
         led_service();
 
+        poll_console_keys(next_ui);
         redraw_dashboard(next_ui);
 
-        tight_loop_contents();
+        // Sleep until the next IRQ (cyw43, UART, PPS, or the 50 ms LED timer)
+        core_load_idle();
     }
 }
 
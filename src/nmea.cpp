@@ -0,0 +1,206 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "nmea.h"
+
+namespace {
+
+// Character classes for the tokenizer loop
+enum : uint8_t {
+    C_DATA  = 0,
+    C_COMMA = 1,
+    C_STAR  = 2,
+    C_END   = 3,   // NUL, CR, LF
+};
+
+struct Tables {
+    uint8_t cls[256];
+    uint8_t hex[256];   // 0..15, or 0xFF for non-hex
+};
+
+constexpr Tables make_tables() {
+    Tables t{};
+    for (int c = 0; c < 256; ++c) {
+        t.cls[c] = C_DATA;
+        t.hex[c] = 0xFF;
+    }
+    t.cls[0]    = C_END;
+    t.cls['\r'] = C_END;
+    t.cls['\n'] = C_END;
+    t.cls[',']  = C_COMMA;
+    t.cls['*']  = C_STAR;
+    for (int c = '0'; c <= '9'; ++c) t.hex[c] = static_cast<uint8_t>(c - '0');
+    for (int c = 'A'; c <= 'F'; ++c) t.hex[c] = static_cast<uint8_t>(c - 'A' + 10);
+    for (int c = 'a'; c <= 'f'; ++c) t.hex[c] = static_cast<uint8_t>(c - 'a' + 10);
+    return t;
+}
+
+constexpr Tables k_tab = make_tables();
+
+} // namespace
+
+NmeaResult nmea_tokenize(const char* line, NmeaSentence* out) {
+    if (!line || !out || line[0] != '$') return NmeaResult::NotNmea;
+
+    const char* p     = line + 1;
+    const char* start = p;
+    uint32_t    n     = 0;
+    uint8_t     sum   = 0;
+
+    for (;;) {
+        const uint8_t c   = static_cast<uint8_t>(*p);
+        const uint8_t cls = k_tab.cls[c];
+
+        if (cls == C_DATA) {
+            sum ^= c;
+            ++p;
+            continue;
+        }
+
+        // Field boundary
+        if (n == NMEA_MAX_FIELDS) return NmeaResult::TooManyFields;
+        out->field[n].p   = start;
+        out->field[n].len = static_cast<uint32_t>(p - start);
+        ++n;
+
+        if (cls != C_COMMA) break;
+        sum ^= c;
+        start = ++p;
+    }
+    out->count = n;
+
+    if (*p != '*') return NmeaResult::NoChecksum;
+
+    const uint8_t hi = k_tab.hex[static_cast<uint8_t>(p[1])];
+    if (hi == 0xFF) return NmeaResult::NoChecksum;
+    const uint8_t lo = k_tab.hex[static_cast<uint8_t>(p[2])];
+    if (lo == 0xFF) return NmeaResult::NoChecksum;
+
+    return (((hi << 4) | lo) == sum) ? NmeaResult::Ok : NmeaResult::BadChecksum;
+}
+
+namespace {
+
+inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+inline uint32_t two_digits(const char* p) {
+    return static_cast<uint32_t>(p[0] - '0') * 10u + static_cast<uint32_t>(p[1] - '0');
+}
+
+// Split "iii.fff" into the integer part and the fraction scaled to
+// frac_digits decimal places (extra digits truncated, missing ones padded).
+bool parse_decimal(const NmeaField& f, uint32_t frac_digits, uint32_t* ipart, uint32_t* fpart) {
+    if (f.len == 0 || frac_digits > 9) return false;
+
+    uint32_t i = 0;
+    uint32_t v = 0;
+    for (; i < f.len && is_digit(f.p[i]); ++i) {
+        const uint32_t d = static_cast<uint32_t>(f.p[i] - '0');
+        if (v > (0xFFFFFFFFu - d) / 10u) return false;   // would overflow
+        v = v * 10u + d;
+    }
+    if (i == 0) return false;
+
+    uint32_t frac = 0;
+    uint32_t used = 0;
+    if (i < f.len) {
+        if (f.p[i] != '.') return false;
+        for (++i; i < f.len; ++i) {
+            if (!is_digit(f.p[i])) return false;
+            if (used < frac_digits) {
+                frac = frac * 10u + static_cast<uint32_t>(f.p[i] - '0');
+                ++used;
+            }
+        }
+    }
+    for (; used < frac_digits; ++used) frac *= 10u;
+
+    *ipart = v;
+    *fpart = frac;
+    return true;
+}
+
+constexpr uint32_t k_pow10[] = {1u, 10u, 100u, 1000u, 10000u, 100000u,
+                                1000000u, 10000000u, 100000000u, 1000000000u};
+
+} // namespace
+
+bool nmea_parse_u32(const NmeaField& f, uint32_t* out) {
+    uint32_t v = 0, frac = 0;
+    if (!parse_decimal(f, 0, &v, &frac)) return false;
+    for (uint32_t i = 0; i < f.len; ++i) if (!is_digit(f.p[i])) return false;
+    *out = v;
+    return true;
+}
+
+bool nmea_parse_fixed(const NmeaField& f, uint32_t frac_digits, int32_t* out) {
+    uint32_t v = 0, frac = 0;
+    if (!parse_decimal(f, frac_digits, &v, &frac)) return false;
+
+    const uint64_t scaled = static_cast<uint64_t>(v) * k_pow10[frac_digits] + frac;
+    if (scaled > 0x7FFFFFFFu) return false;
+    *out = static_cast<int32_t>(scaled);
+    return true;
+}
+
+bool nmea_parse_time_ms(const NmeaField& f, int32_t* ms_of_day) {
+    if (f.len < 6) return false;
+    for (uint32_t i = 0; i < 6; ++i) if (!is_digit(f.p[i])) return false;
+
+    const uint32_t hh = two_digits(f.p);
+    const uint32_t mm = two_digits(f.p + 2);
+    const uint32_t ss = two_digits(f.p + 4);
+    if (hh > 23 || mm > 59 || ss > 60) return false;
+
+    uint32_t v = 0, ms = 0;
+    if (!parse_decimal(f, 3, &v, &ms)) return false;
+
+    *ms_of_day = static_cast<int32_t>(((hh * 60u + mm) * 60u + ss) * 1000u + ms);
+    return true;
+}
+
+bool nmea_parse_ddmmyy(const NmeaField& f, int32_t* year, int32_t* month, int32_t* day) {
+    if (f.len != 6) return false;
+    for (uint32_t i = 0; i < 6; ++i) if (!is_digit(f.p[i])) return false;
+
+    const uint32_t d = two_digits(f.p);
+    const uint32_t m = two_digits(f.p + 2);
+    const uint32_t y = two_digits(f.p + 4);
+    if (m < 1 || m > 12 || d < 1 || d > 31) return false;
+
+    // Common GPS assumption: 2000..2099
+    *year  = 2000 + static_cast<int32_t>(y);
+    *month = static_cast<int32_t>(m);
+    *day   = static_cast<int32_t>(d);
+    return true;
+}
+
+bool nmea_parse_coord(const NmeaField& value, const NmeaField& hemi, int32_t* udeg) {
+    if (hemi.len != 1) return false;
+
+    // Minutes to 6 places: mm.mmmmmm -> micro-minutes, then / 60
+    uint32_t v = 0, frac = 0;
+    if (!parse_decimal(value, 6, &v, &frac)) return false;
+
+    const uint32_t deg = v / 100u;
+    const uint32_t min = v % 100u;
+    if (deg > 180u || min > 59u) return false;
+
+    const uint32_t umin = min * 1000000u + frac;
+    const int32_t  mag  = static_cast<int32_t>(deg * 1000000u + umin / 60u);
+
+    switch (hemi.p[0]) {
+        case 'N': case 'E': *udeg =  mag; return true;
+        case 'S': case 'W': *udeg = -mag; return true;
+    }
+    return false;
+}
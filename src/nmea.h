@@ -0,0 +1,67 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <cstdint>
+
+// Single-pass NMEA 0183 tokenizer. One walk over "$<addr>,f1,...,fn*hh"
+// records every field's span and the XOR checksum together; a sentence with
+// a missing or wrong checksum is rejected before any handler sees it.
+// Fields point into the caller's line (no copies, no NUL terminators).
+
+constexpr uint32_t NMEA_MAX_FIELDS = 24;
+
+struct NmeaField {
+    const char* p   = "";
+    uint32_t    len = 0;
+};
+
+struct NmeaSentence {
+    NmeaField field[NMEA_MAX_FIELDS];   // field[0] = address, e.g. "GNRMC"
+    uint32_t  count = 0;
+
+    // Field i, or an empty field if the sentence is shorter.
+    const NmeaField& at(uint32_t i) const {
+        static const NmeaField none{};
+        return (i < count) ? field[i] : none;
+    }
+    bool empty(uint32_t i) const { return at(i).len == 0; }
+};
+
+enum class NmeaResult : uint8_t {
+    Ok = 0,
+    NotNmea,        // no leading '$'
+    NoChecksum,     // no "*hh"
+    BadChecksum,
+    TooManyFields,
+};
+
+NmeaResult nmea_tokenize(const char* line, NmeaSentence* out);
+
+// Fixed-point field parsers. They work on the field span only (no libc, no
+// floats) and return false on an empty or malformed field.
+
+// Unsigned decimal integer ("08")
+bool nmea_parse_u32(const NmeaField& f, uint32_t* out);
+
+// Decimal with up to 9 fraction digits, scaled by 10^frac_digits and
+// truncated: ("0.95", 2) -> 95, ("12", 2) -> 1200.
+bool nmea_parse_fixed(const NmeaField& f, uint32_t frac_digits, int32_t* out);
+
+// "hhmmss" / "hhmmss.sss" -> milliseconds since 00:00 UTC (leap second 60 allowed)
+bool nmea_parse_time_ms(const NmeaField& f, int32_t* ms_of_day);
+
+// "ddmmyy" -> year (2000-2099) / month / day
+bool nmea_parse_ddmmyy(const NmeaField& f, int32_t* year, int32_t* month, int32_t* day);
+
+// "ddmm.mmmm" or "dddmm.mmmm" plus N/S/E/W -> signed micro-degrees
+bool nmea_parse_coord(const NmeaField& value, const NmeaField& hemi, int32_t* udeg);
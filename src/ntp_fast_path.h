@@ -0,0 +1,33 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+// lwIP IPv4 input hook for the NTP early-demux fast path. Included by lwIP's
+// C sources via LWIP_HOOK_FILENAME (see lwipopts.h), so keep it plain C.
+//
+// Recognises unicast IPv4/UDP/123 client requests that need no special
+// handling, answers them in the received frame and returns 1 (consumed).
+// Anything else returns 0 and continues through ip4_input() to udp_recv.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct pbuf;
+struct netif;
+
+int ntp_fast_path_ip4_input(struct pbuf* p, struct netif* inp);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,85 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "ntp_packet.h"
+
+#include "timebase.h"
+
+void ntp_fill_response(NtpPacket* rsp,
+                       const NtpPacket* req,
+                       uint32_t t2s, uint32_t t2f,
+                       uint32_t t3s, uint32_t t3f,
+                       bool interleaved) {
+    const uint8_t  vn       = ntp_normalize_vn(ntp_extract_vn(req->li_vn_mode));
+    const uint8_t  req_poll = req->poll;
+    const uint32_t req_tx_s = interleaved ? req->recv_ts_s : req->tx_ts_s;
+    const uint32_t req_tx_f = interleaved ? req->recv_ts_f : req->tx_ts_f;
+
+    // Header fields follow the discipline state (cached by the timebase
+    // writer, so this is one small copy per reply)
+    TimebaseQuality q;
+    (void)timebase_get_quality(&q);
+
+    rsp->li_vn_mode = ntp_make_li_vn_mode(q.leap, vn, /*mode=*/4u); // server mode
+    rsp->stratum    = q.stratum;
+    rsp->poll       = req_poll;
+    rsp->precision  = q.precision;
+
+    // The reference clock is local, so there is no path delay to it.
+    rsp->root_delay      = hton32(0);
+    rsp->root_dispersion = hton32(q.root_dispersion);
+    rsp->ref_id          = hton32(NTP_REFID_GPS);
+
+    // Originate timestamp: echo client's transmit (or, interleaved, receive)
+    // timestamp verbatim (already network order)
+    rsp->orig_ts_s = req_tx_s;
+    rsp->orig_ts_f = req_tx_f;
+
+    // Reference (last discipline update)/Receive/Transmit: host -> network
+    rsp->ref_ts_s  = hton32(q.ref_ts_s);
+    rsp->ref_ts_f  = hton32(q.ref_ts_f);
+
+    rsp->recv_ts_s = hton32(t2s);
+    rsp->recv_ts_f = hton32(t2f);
+
+    rsp->tx_ts_s   = hton32(t3s);
+    rsp->tx_ts_f   = hton32(t3f);
+}
+
+void ntp_fill_kod(NtpPacket* pkt, uint32_t kiss_code) {
+    const uint8_t  vn   = ntp_normalize_vn(ntp_extract_vn(pkt->li_vn_mode));
+    const uint32_t tx_s = pkt->tx_ts_s;
+    const uint32_t tx_f = pkt->tx_ts_f;
+
+    pkt->li_vn_mode = ntp_make_li_vn_mode(3u, vn, /*mode=*/4u);
+    pkt->stratum    = 0;
+    pkt->precision  = NTP_PRECISION;
+
+    pkt->root_delay      = hton32(0);
+    pkt->root_dispersion = hton32(0);
+    pkt->ref_id          = hton32(kiss_code);
+
+    pkt->ref_ts_s  = 0;
+    pkt->ref_ts_f  = 0;
+    pkt->orig_ts_s = tx_s;
+    pkt->orig_ts_f = tx_f;
+    pkt->recv_ts_s = tx_s;
+    pkt->recv_ts_f = tx_f;
+    pkt->tx_ts_s   = tx_s;
+    pkt->tx_ts_f   = tx_f;
+}
+
+bool ntp_is_interleaved_request(const NtpPacket* req, const ClientEntry* ce) {
+    if (!ce || (ce->tx_ts_s == 0 && ce->tx_ts_f == 0)) return false;
+    if (req->orig_ts_s != hton32(ce->rx_ts_s) || req->orig_ts_f != hton32(ce->rx_ts_f)) return false;
+    return (req->recv_ts_s != req->tx_ts_s) || (req->recv_ts_f != req->tx_ts_f);
+}
@@ -0,0 +1,91 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <cstdint>
+
+#include "client_log.h"
+
+// NTP packet layout and reply construction, independent of lwIP so it can be
+// built and exercised on the host. Timestamps passed in are host order;
+// fields in NtpPacket are network order.
+
+static constexpr int8_t   NTP_PRECISION = -20;        // 1 us timer tick (KoD; replies use the measured value)
+static constexpr uint32_t NTP_REFID_GPS = 0x47505300;  // "GPS\0"
+static constexpr uint32_t NTP_KOD_RATE  = 0x52415445;  // "RATE"
+
+#pragma pack(push, 1)
+struct NtpPacket {
+    uint8_t  li_vn_mode;     // LI (2) | VN (3) | Mode (3)
+    uint8_t  stratum;
+    uint8_t  poll;
+    int8_t   precision;
+    uint32_t root_delay;
+    uint32_t root_dispersion;
+    uint32_t ref_id;
+
+    uint32_t ref_ts_s;
+    uint32_t ref_ts_f;
+
+    uint32_t orig_ts_s;
+    uint32_t orig_ts_f;
+
+    uint32_t recv_ts_s;
+    uint32_t recv_ts_f;
+
+    uint32_t tx_ts_s;
+    uint32_t tx_ts_f;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(NtpPacket) == 48, "NTP header is 48 bytes");
+
+static inline uint8_t ntp_extract_vn(uint8_t li_vn_mode) {
+    return (li_vn_mode >> 3) & 0x07;
+}
+
+static inline uint8_t ntp_make_li_vn_mode(uint8_t li, uint8_t vn, uint8_t mode) {
+    return static_cast<uint8_t>(((li & 0x03u) << 6) | ((vn & 0x07u) << 3) | (mode & 0x07u));
+}
+
+static inline uint8_t ntp_normalize_vn(uint8_t vn) {
+    // Accept v3/v4, clamp everything else to v4
+    if (vn < 3 || vn > 4) return 4;
+    return vn;
+}
+
+// Both the RP2040 and the host are little-endian.
+static inline uint32_t hton32(uint32_t x) {
+    return (x << 24) | ((x & 0xFF00u) << 8) | ((x >> 8) & 0xFF00u) | (x >> 24);
+}
+
+// rsp may alias req (in-place response): everything needed from the request
+// is read before the first write.
+//
+// Interleaved mode (draft-ietf-ntp-interleaved-modes, as served by chrony):
+// the origin echoes the client's receive timestamp, and t3 is the precise
+// transmit time of our *previous* reply to this client.
+void ntp_fill_response(NtpPacket* rsp,
+                       const NtpPacket* req,
+                       uint32_t t2s, uint32_t t2f,
+                       uint32_t t3s, uint32_t t3f,
+                       bool interleaved);
+
+// Kiss-o'-Death: stratum 0, kiss code in ref_id, LI alarm. The origin
+// and receive/transmit fields mirror the client's transmit timestamp, like
+// chrony, so no timebase read is needed. pkt is rewritten in place.
+void ntp_fill_kod(NtpPacket* pkt, uint32_t kiss_code);
+
+// A client asks for an interleaved reply by putting the receive timestamp of
+// our previous reply into its origin field (and rx != tx, which a basic-mode
+// client never sends).
+bool ntp_is_interleaved_request(const NtpPacket* req, const ClientEntry* ce);
@@ -17,95 +17,191 @@
 #include "lwip/udp.h"
 #include "lwip/pbuf.h"
 #include "lwip/ip_addr.h"
+#include "lwip/netif.h"
+#include "lwip/inet_chksum.h"
+#include "lwip/prot/ip4.h"
+#include "lwip/prot/udp.h"
 
 #include "timebase.h"
+#include "client_log.h"
+#include "ntp_packet.h"
+#include "pico/time.h"
+#include "ntp_fast_path.h"
 
 static constexpr uint16_t NTP_PORT = 123;
-static constexpr int8_t   NTP_PRECISION = -20;        // ~1 us-ish (placeholder)
-static constexpr uint32_t NTP_REFID_GPS = 0x47505300;  // "GPS\0"
+
+// Per-source rate limiting (token bucket in client_log).
+// Ticks are time_us_64() >> 10 (1.024 ms).
+static constexpr uint32_t ms_to_ticks(uint32_t ms) { return (ms * 1000u) >> 10; }
+static constexpr uint32_t RATELIMIT_INTERVAL_TICKS = ms_to_ticks(2000);  // 1 request / 2 s sustained
+static constexpr uint32_t RATELIMIT_BURST          = 8;                  // iburst fits
+// true: answer over-limit clients with KoD RATE (at most once per interval),
+// false: drop them silently.
+static constexpr bool     RATELIMIT_SEND_KOD       = true;
 
 static udp_pcb* g_pcb = nullptr;
 bool n_status = false;
 
-#pragma pack(push, 1)
-struct NtpPacket {
-    uint8_t  li_vn_mode;     // LI (2) | VN (3) | Mode (3)
-    uint8_t  stratum;
-    uint8_t  poll;
-    int8_t   precision;
-    uint32_t root_delay;
-    uint32_t root_dispersion;
-    uint32_t ref_id;
+static NtpServerStats g_stats{};
+
+// Original netif input function, wrapped by ntp_rx_stamp_input()
+static netif_input_fn g_next_input = nullptr;
 
-    uint32_t ref_ts_s;
-    uint32_t ref_ts_f;
 
-    uint32_t orig_ts_s;
-    uint32_t orig_ts_f;
+// Where a reply goes. The udp_recv path sends through the PCB; the fast path
+// has already turned the IP/UDP headers around and hands the frame straight
+// to the netif. p->payload is whatever the send function expects.
+struct NtpTx {
+    err_t (*send)(const NtpTx* tx, pbuf* p);
 
-    uint32_t recv_ts_s;
-    uint32_t recv_ts_f;
+    // udp_recv path
+    udp_pcb*         pcb  = nullptr;
+    const ip_addr_t* addr = nullptr;
+    u16_t            port = 0;
 
-    uint32_t tx_ts_s;
-    uint32_t tx_ts_f;
+    // fast path: outgoing interface and the reply's addresses
+    netif*     nif = nullptr;
+    ip4_addr_t src{};
+    ip4_addr_t dst{};
 };
-#pragma pack(pop)
 
-static inline uint8_t ntp_extract_vn(uint8_t li_vn_mode) {
-    return (li_vn_mode >> 3) & 0x07;
+static err_t ntp_send_udp(const NtpTx* tx, pbuf* p) {
+    return udp_sendto(tx->pcb, p, tx->addr, tx->port);
 }
 
-static inline uint8_t ntp_make_li_vn_mode(uint8_t li, uint8_t vn, uint8_t mode) {
-    return static_cast<uint8_t>(((li & 0x03u) << 6) | ((vn & 0x07u) << 3) | (mode & 0x07u));
+static bool ntp_get_time(uint64_t local_us, uint32_t* s, uint32_t* f) {
+    // timebase returns seconds+fraction in host order
+    return timebase_local_to_ntp(local_us, s, f);
 }
 
-static inline uint8_t ntp_normalize_vn(uint8_t vn) {
-    // Accept v3/v4, clamp everything else to v4
-    if (vn < 3 || vn > 4) return 4;
-    return vn;
+static void ntp_note_turnaround(uint64_t t2_us, uint64_t t3_us) {
+    hist_add(&g_stats.turnaround, static_cast<uint32_t>(t3_us - t2_us));
 }
 
-static inline uint32_t hton32(uint32_t x) { return lwip_htonl(x); }
+// Fill the reply at `rsp` (inside `out`, and possibly aliasing req), send it,
+// and remember when it actually left so the client can ask for it next time.
+// Returns true once the send function has accepted the reply.
+static bool ntp_reply(const NtpTx* tx, pbuf* out, NtpPacket* rsp, const NtpPacket* req,
+                      ClientEntry* ce, uint64_t t2_us) {
+    // First timebase read on the request path
+    uint32_t t2s = 0, t2f = 0;
+    if (!ntp_get_time(t2_us, &t2s, &t2f)) {
+        g_stats.dropped++;
+        pbuf_free(out);
+        return false;
+    }
+
+    const bool interleaved = ntp_is_interleaved_request(req, ce);
+
+    const uint64_t t3_us = time_us_64();
+    uint32_t t3s = 0, t3f = 0;
+    if (interleaved) {
+        t3s = ce->tx_ts_s;
+        t3f = ce->tx_ts_f;
+    } else if (!ntp_get_time(t3_us, &t3s, &t3f)) {
+        g_stats.dropped++;
+        pbuf_free(out);
+        return false;
+    }
+
+    ntp_fill_response(rsp, req, t2s, t2f, t3s, t3f, interleaved);
+    ntp_note_turnaround(t2_us, t3_us);
+
+    const err_t err = tx->send(tx, out);
+
+    // The send returns after the cyw43 driver has clocked the frame out,
+    // so this is our best estimate of the real transmit time.
+    const uint64_t sent_us = time_us_64();
+    pbuf_free(out);
 
-static bool ntp_get_time(uint32_t* s, uint32_t* f) {
-    // timebase_now_ntp returns seconds+fraction in host order
-    return timebase_now_ntp(s, f);
+    if (err != ERR_OK) return false;
+    g_stats.tx++;
+    if (interleaved) g_stats.interleaved++;
+    hist_add(&g_stats.residence, static_cast<uint32_t>(sent_us - t2_us));
+
+    uint32_t sent_s = 0, sent_f = 0;
+    if (ce && ntp_get_time(sent_us, &sent_s, &sent_f)) {
+        ce->rx_ts_s = t2s;
+        ce->rx_ts_f = t2f;
+        ce->tx_ts_s = sent_s;
+        ce->tx_ts_f = sent_f;
+    }
+    return true;
 }
 
-static void ntp_fill_response(NtpPacket* rsp,
-                              const NtpPacket* req,
-                              uint32_t t2s, uint32_t t2f,
-                              uint32_t t3s, uint32_t t3f) {
-    const uint8_t vn = ntp_normalize_vn(ntp_extract_vn(req->li_vn_mode));
+// Fallback for chained or non-48-byte requests: copy out, allocate a reply.
+static void ntp_reply_copy(const NtpTx* tx, pbuf* p, ClientEntry* ce, uint64_t t2_us) {
+    NtpPacket req{};
+    const u16_t copied = pbuf_copy_partial(p, &req, sizeof(req), 0);
+    pbuf_free(p);
 
-    const bool have_time = timebase_have_time();
-    const bool synced    = timebase_is_synced();
+    if (copied != sizeof(req)) {
+        g_stats.dropped++;
+        return;
+    }
+
+    pbuf* out = pbuf_alloc(PBUF_TRANSPORT, sizeof(NtpPacket), PBUF_RAM);
+    g_stats.pbuf_allocs++;
+    if (!out) {
+        g_stats.alloc_failures++;
+        return;
+    }
+
+    if (ntp_reply(tx, out, static_cast<NtpPacket*>(out->payload), &req, ce, t2_us)) {
+        g_stats.copied++;
+    }
+}
 
-    // LI: 0 = no warning, 3 = alarm/unsynchronized
-    const uint8_t li = synced ? 0u : 3u;
+// Rate-limit gate, run before any timebase read. Returns false when the
+// request has been consumed: answered with KoD RATE (only if it can be
+// rewritten in place at kod_pkt, at most once per interval per client) or
+// dropped.
+static bool ntp_admit(const NtpTx* tx, pbuf* p, NtpPacket* kod_pkt,
+                      uint32_t src_ip, uint64_t t2_us, ClientEntry** ce_out) {
+    ClientEntry* ce = client_log_get(src_ip);
+    *ce_out = ce;
 
-    rsp->li_vn_mode = ntp_make_li_vn_mode(li, vn, /*mode=*/4u); // server mode
-    rsp->stratum    = have_time ? (synced ? 1 : 2) : 16;
-    rsp->poll       = req->poll;
-    rsp->precision  = NTP_PRECISION;
+    const uint32_t now_tick = static_cast<uint32_t>(t2_us >> 10);
+    if (client_log_allow(ce, now_tick, RATELIMIT_INTERVAL_TICKS, RATELIMIT_BURST)) return true;
+
+    g_stats.rate_limited++;
+
+    if (RATELIMIT_SEND_KOD && kod_pkt &&
+        client_log_kod_due(ce, now_tick, RATELIMIT_INTERVAL_TICKS)) {
+        ntp_fill_kod(kod_pkt, NTP_KOD_RATE);
+        if (tx->send(tx, p) == ERR_OK) g_stats.kod_sent++;
+    }
+    pbuf_free(p);
+    return false;
+}
+
+// Runs as soon as the cyw43 driver has read a frame off the bus, before
+// ethernet/IP/UDP demux. Every received pbuf gets its arrival time.
+static err_t ntp_rx_stamp_input(pbuf* p, netif* inp) {
+    if (p) p->rx_local_us = time_us_64();
+    return g_next_input(p, inp);
+}
 
-    rsp->root_delay      = hton32(0);
-    rsp->root_dispersion = hton32(0);
-    rsp->ref_id          = hton32(NTP_REFID_GPS);
+static void ntp_install_rx_stamp() {
+    netif* nif = netif_default;
+    if (!nif || !nif->input || nif->input == ntp_rx_stamp_input) return;
 
-    // Originate timestamp: echo client's transmit timestamp verbatim (already network order)
-    rsp->orig_ts_s = req->tx_ts_s;
-    rsp->orig_ts_f = req->tx_ts_f;
+    g_next_input = nif->input;
+    nif->input   = ntp_rx_stamp_input;
+}
 
-    // Reference/Receive/Transmit timestamps: host -> network
-    rsp->ref_ts_s  = hton32(t2s);
-    rsp->ref_ts_f  = hton32(t2f);
+// T2 is the frame's arrival stamp when present, otherwise handler entry.
+static uint64_t ntp_rx_time(const pbuf* p) {
+    const uint64_t entry_us = time_us_64();
+    const uint64_t rx_us = p->rx_local_us;
 
-    rsp->recv_ts_s = hton32(t2s);
-    rsp->recv_ts_f = hton32(t2f);
+    if (rx_us == 0 || rx_us > entry_us) {
+        g_stats.rx_unstamped++;
+        return entry_us;
+    }
 
-    rsp->tx_ts_s   = hton32(t3s);
-    rsp->tx_ts_f   = hton32(t3f);
+    hist_add(&g_stats.rx_to_handler, static_cast<uint32_t>(entry_us - rx_us));
+    return rx_us;
 }
 
 static void on_ntp_rx(void*,
@@ -115,38 +211,139 @@ static void on_ntp_rx(void*,
                       u16_t port) {
     if (!p) return;
 
-    if (p->tot_len < sizeof(NtpPacket)) {
+    const uint64_t t2_us = ntp_rx_time(p);
+    g_stats.rx++;
+
+    // Cheap checks first: size, client mode (3), rate limit. No timebase
+    // reads happen until a request is known to be served.
+    if (p->tot_len < sizeof(NtpPacket) || (pbuf_get_at(p, 0) & 0x07u) != 3u) {
+        g_stats.dropped++;
         pbuf_free(p);
         return;
     }
 
-    NtpPacket req{};
-    const u16_t copied = pbuf_copy_partial(p, &req, sizeof(req), 0);
-    pbuf_free(p);
+    const bool single_48 = (p->next == nullptr) && (p->len == sizeof(NtpPacket)) &&
+                           (p->tot_len == sizeof(NtpPacket));
+
+    NtpTx tx{ntp_send_udp};
+    tx.pcb  = pcb;
+    tx.addr = addr;
+    tx.port = port;
+
+    NtpPacket* pkt = single_48 ? static_cast<NtpPacket*>(p->payload) : nullptr;
+    ClientEntry* ce = nullptr;
+    if (!ntp_admit(&tx, p, pkt, ip4_addr_get_u32(ip_2_ip4(addr)), t2_us, &ce)) return;
+
+    if (single_48) {
+        // Zero-allocation path: rewrite the request pbuf and hand it back to
+        // lwIP. udp_sendto() prepends the UDP/IP/Ethernet headers into the
+        // headroom the received frame already had.
+        if (ntp_reply(&tx, p, pkt, pkt, ce, t2_us)) g_stats.in_place++;
+    } else {
+        ntp_reply_copy(&tx, p, ce, t2_us);
+    }
+}
 
-    if (copied != sizeof(req)) return;
+#if NTP_FAST_PATH
 
-    // Only respond to client mode (3)
-    const uint8_t mode = req.li_vn_mode & 0x07u;
-    if (mode != 3u) return;
+// IPv4 + UDP + NTP, no IP options
+static constexpr u16_t FAST_FRAME_LEN = IP_HLEN + UDP_HLEN + sizeof(NtpPacket);
 
-    uint32_t t2s = 0, t2f = 0;
-    if (!ntp_get_time(&t2s, &t2f)) return;
+// Finish the reply (UDP checksum over the new payload) and send it without
+// going back through udp_sendto()/ip4_output().
+static err_t ntp_send_fast(const NtpTx* tx, pbuf* p) {
+    auto* udph = reinterpret_cast<udp_hdr*>(static_cast<uint8_t*>(p->payload) + IP_HLEN);
+    udph->chksum = 0;
 
-    uint32_t t3s = 0, t3f = 0;
-    if (!ntp_get_time(&t3s, &t3f)) return;
+    if (pbuf_remove_header(p, IP_HLEN) != 0) return ERR_BUF;
+    u16_t sum = inet_chksum_pseudo(p, IP_PROTO_UDP, p->tot_len, &tx->src, &tx->dst);
+    pbuf_add_header(p, IP_HLEN);
+    udph->chksum = (sum == 0) ? 0xffffu : sum;
 
-    NtpPacket rsp{};
-    ntp_fill_response(&rsp, &req, t2s, t2f, t3s, t3f);
+    return tx->nif->output(tx->nif, p, &tx->dst);
+}
 
-    pbuf* out = pbuf_alloc(PBUF_TRANSPORT, sizeof(rsp), PBUF_RAM);
-    if (!out) return;
+// Everything after "UDP to port 123": anything we would rather not handle
+// by hand (options, fragments, broadcast, bad checksums, odd sizes) goes back
+// to lwIP. May trim Ethernet padding off p.
+static bool ntp_fast_path_accept(pbuf* p, netif* inp, ip4_addr_t* client, ip4_addr_t* local) {
+    auto* iph = static_cast<ip_hdr*>(p->payload);
+
+    if (p->len < FAST_FRAME_LEN || lwip_ntohs(IPH_LEN(iph)) != FAST_FRAME_LEN) return false;
+    if ((lwip_ntohs(IPH_OFFSET(iph)) & (IP_MF | IP_OFFMASK)) != 0) return false;
+
+    ip4_addr_copy(*client, iph->src);
+    ip4_addr_copy(*local, iph->dest);
+    if (!netif_is_up(inp) || !inp->output) return false;
+    if (ip4_addr_get_u32(local) != ip4_addr_get_u32(netif_ip4_addr(inp))) return false;
+    if (ip4_addr_isany_val(*client) || ip4_addr_ismulticast(client) ||
+        ip4_addr_isbroadcast(client, inp)) return false;
+
+    auto* udph = reinterpret_cast<const udp_hdr*>(static_cast<const uint8_t*>(p->payload) + IP_HLEN);
+    auto* pkt  = reinterpret_cast<const NtpPacket*>(reinterpret_cast<const uint8_t*>(udph) + UDP_HLEN);
+    if (lwip_ntohs(udph->len) != UDP_HLEN + sizeof(NtpPacket)) return false;
+    if ((pkt->li_vn_mode & 0x07u) != 3u) return false;
+
+    if (inet_chksum(iph, IP_HLEN) != 0) return false;
+
+    if (p->tot_len > FAST_FRAME_LEN) pbuf_realloc(p, FAST_FRAME_LEN);
+    if (udph->chksum != 0) {
+        if (pbuf_remove_header(p, IP_HLEN) != 0) return false;
+        const u16_t sum = inet_chksum_pseudo(p, IP_PROTO_UDP, p->tot_len, client, local);
+        pbuf_add_header(p, IP_HLEN);
+        if (sum != 0) return false;
+    }
+    return true;
+}
 
-    std::memcpy(out->payload, &rsp, sizeof(rsp));
-    (void)udp_sendto(pcb, out, addr, port);
-    pbuf_free(out);
+extern "C" int ntp_fast_path_ip4_input(struct pbuf* p, struct netif* inp) {
+    if (!g_pcb || !p || !inp) return 0;
+
+    // Cheapest possible reject for all non-NTP traffic
+    auto* iph = static_cast<ip_hdr*>(p->payload);
+    if (p->len < IP_HLEN + UDP_HLEN || IPH_HL_BYTES(iph) != IP_HLEN ||
+        IPH_PROTO(iph) != IP_PROTO_UDP) return 0;
+    auto* udph = reinterpret_cast<udp_hdr*>(static_cast<uint8_t*>(p->payload) + IP_HLEN);
+    if (udph->dest != PP_HTONS(NTP_PORT)) return 0;
+
+    ip4_addr_t client{}, local{};
+    if (!ntp_fast_path_accept(p, inp, &client, &local)) {
+        g_stats.fast_fallback++;
+        return 0;
+    }
+
+    // From here on the frame is ours and always consumed.
+    const uint64_t t2_us = ntp_rx_time(p);
+    g_stats.rx++;
+
+    // Turn the headers around; the UDP checksum is done at send time.
+    ip4_addr_copy(iph->src, local);
+    ip4_addr_copy(iph->dest, client);
+    IPH_TOS_SET(iph, 0);
+    IPH_ID_SET(iph, 0);
+    IPH_OFFSET_SET(iph, PP_HTONS(IP_DF));
+    IPH_TTL_SET(iph, UDP_TTL);
+    IPH_CHKSUM_SET(iph, 0);
+    IPH_CHKSUM_SET(iph, inet_chksum(iph, IP_HLEN));
+
+    udph->dest = udph->src;
+    udph->src  = PP_HTONS(NTP_PORT);
+
+    NtpTx tx{ntp_send_fast};
+    tx.nif = inp;
+    tx.src = local;
+    tx.dst = client;
+
+    auto* pkt = reinterpret_cast<NtpPacket*>(reinterpret_cast<uint8_t*>(udph) + UDP_HLEN);
+    ClientEntry* ce = nullptr;
+    if (!ntp_admit(&tx, p, pkt, ip4_addr_get_u32(&client), t2_us, &ce)) return 1;
+
+    if (ntp_reply(&tx, p, pkt, pkt, ce, t2_us)) g_stats.fast_path++;
+    return 1;
 }
 
+#endif // NTP_FAST_PATH
+
 void ntp_server_init() {
     if (g_pcb) {
         // Already initialized; keep status as-is.
@@ -167,6 +364,7 @@ void ntp_server_init() {
     }
 
     udp_recv(g_pcb, on_ntp_rx, nullptr);
+    ntp_install_rx_stamp();
     n_status = true;
 }
 
@@ -183,7 +381,25 @@ void ntp_server_init() {
 //     n_status = false;
 // }
 
+#if NTP_BENCH
+
+void ntp_server_bench_rx(struct pbuf* p, uint32_t src_ip, uint16_t port) {
+    if (!g_pcb) {
+        pbuf_free(p);
+        return;
+    }
+    const ip_addr_t addr = IPADDR4_INIT(src_ip);
+    on_ntp_rx(nullptr, g_pcb, p, &addr, port);
+}
+
+#endif
+
 bool ntp_server_is_running() {
     return (g_pcb != nullptr) && n_status;
 }
 
+void ntp_server_get_stats(NtpServerStats* out) {
+    if (!out) return;
+    *out = g_stats;
+}
+
@@ -13,6 +13,8 @@
 #pragma once
 #include <cstdint>
 
+#include "latency_hist.h"
+
 // True when the server successfully bound UDP/123 and registered its recv callback.
 extern bool n_status;
 
@@ -22,3 +24,33 @@ void ntp_server_init();
 // Convenience helper (optional, but nice for UI).
 bool ntp_server_is_running();
 
+// Counters are updated from the lwIP context; a UI snapshot may be slightly torn.
+struct NtpServerStats {
+    uint32_t rx             = 0;   // datagrams delivered to the handler
+    uint32_t tx             = 0;   // replies accepted by udp_sendto()
+    uint32_t in_place       = 0;   // replies sent from the request pbuf (no allocation)
+    uint32_t copied         = 0;   // replies sent via copy + pbuf_alloc (chained / odd size)
+    uint32_t fast_path      = 0;   // replies sent from the IPv4 input hook (NTP_FAST_PATH)
+    uint32_t fast_fallback  = 0;   // UDP/123 frames the hook passed on to udp_recv
+    uint32_t interleaved    = 0;   // replies sent in interleaved mode
+    uint32_t pbuf_allocs    = 0;   // pbuf_alloc() calls made by the server
+    uint32_t alloc_failures = 0;
+    uint32_t dropped        = 0;   // short, non-client, or no time yet
+    uint32_t rate_limited   = 0;   // over the per-client token bucket
+    uint32_t kod_sent       = 0;   // KoD RATE replies
+    uint32_t rx_unstamped   = 0;   // no arrival stamp; T2 taken at handler entry
+    LatencyHist rx_to_handler{};   // frame arrival -> handler entry (us)
+    LatencyHist turnaround{};      // T2 -> T3 (us)
+    LatencyHist residence{};       // frame arrival -> reply handed to the driver (us)
+};
+
+void ntp_server_get_stats(NtpServerStats* out);
+
+#if NTP_BENCH
+struct pbuf;
+// Benchmark entry: hand p (a UDP payload) to the receive callback as if it
+// came from src_ip (network order):port. Takes ownership of p; call with
+// the lwIP lock held.
+void ntp_server_bench_rx(struct pbuf* p, uint32_t src_ip, uint16_t port);
+#endif
+
@@ -1,39 +1,214 @@
 #include "pps.h"
+#include "int_math.h"
+#include "seq_ring.h"
 
 #include "hardware/gpio.h"
 #include "hardware/timer.h"
+#if PPS_PIO
+#include "hardware/pio.h"
+#include "hardware/clocks.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "pps_capture.pio.h"
+#endif
 #include <cstdio>
 
 static uint32_t g_pps_gpio = 16;
 
-static volatile uint32_t g_pps_edges = 0;
-static volatile uint32_t g_pps_last_interval_us = 0;
+// Written only by the capture IRQ
+static SeqRing<PpsEdge, PPS_HISTORY> g_pps_ring;
 
-// NEW: last edge absolute time (microseconds since boot)
-static volatile uint64_t g_pps_last_edge_us = 0;
-
-static void pps_irq_callback(uint gpio, uint32_t events)
+// Both capture paths end here, in IRQ context. The edge is passed as us
+// since boot plus the ns within that us, so nothing here divides.
+static void pps_record_edge(uint64_t edge_us, uint32_t frac_ns)
 {
-    (void)events;
-    if (gpio != g_pps_gpio) return;
-
-    const uint64_t now_us_64 = time_us_64();
-
     // 32-bit interval is fine (wrap-safe subtraction)
     static uint32_t last_us_32 = 0;
-    const uint32_t now_us_32 = (uint32_t)now_us_64;
+    const uint32_t now_us_32 = (uint32_t)edge_us;
     const uint32_t dt = now_us_32 - last_us_32;
     last_us_32 = now_us_32;
 
-    g_pps_last_interval_us = dt;
-    g_pps_last_edge_us = now_us_64;   // NEW
-    g_pps_edges++;
+    PpsEdge e;
+    e.seq = g_pps_ring.head() + 1u;
+    e.interval_us = (e.seq > 1) ? dt : 0;
+    e.edge_ns = edge_us * 1000u + frac_ns;
+    g_pps_ring.push(e);
+}
+
+#if PPS_PIO
+
+namespace {
+
+// The state machine is enabled this many cycles after the us tick it was
+// synchronised to (spin-loop exit + register write; measured ~4-10).
+constexpr uint32_t START_DELAY_CYCLES = 7;
+
+struct PioCapture {
+    PIO      pio      = pio0;
+    int      sm       = -1;
+    uint     offset   = 0;
+    uint32_t sys_hz   = 0;
+    uint64_t start_us = 0;   // us tick the counter started on
+    uint32_t resyncs  = 0;
+
+    // Fixed at init so the IRQ only multiplies (no FPU, no 64-bit divider).
+    uint64_t ticks_per_us_q32 = 0;   // counter ticks per us, Q32
+    uint32_t half_per_s       = 0;   // clk_sys half-cycles per second
+    uint64_t ns_per_half_q32  = 0;   // ns per half-cycle, Q32
+    uint32_t chunk_half       = 0;   // most whole seconds below 2^32 half-cycles
+    uint32_t chunk_us         = 0;
+
+    // Start of the second the last edge fell in, relative to start_us.
+    uint64_t sec_half = 0;           // half-cycles since start
+    uint64_t sec_us   = 0;           // on the time_us_64() scale
+};
+
+PioCapture g_pio;
+
+// Restart the counter exactly on a us tick so its counts map onto the
+// time_us_64() timescale. clk_sys and the 1 MHz tick both come from the
+// crystal, so the mapping then holds indefinitely.
+void pio_start_synced()
+{
+    PioCapture& c = g_pio;
+    pio_sm_set_enabled(c.pio, c.sm, false);
+    pio_sm_clear_fifos(c.pio, c.sm);
+    pio_sm_restart(c.pio, c.sm);
+    pio_sm_exec(c.pio, c.sm, pio_encode_set(pio_x, 0));
+    pio_sm_exec(c.pio, c.sm, pio_encode_jmp(c.offset + pps_capture_offset_low));
+
+    const uint32_t irq = save_and_disable_interrupts();
+    const uint32_t t0 = time_us_32();
+    uint32_t tick;
+    while ((tick = time_us_32()) == t0) {}
+    pio_sm_set_enabled(c.pio, c.sm, true);
+    const uint64_t now = time_us_64();
+    restore_interrupts(irq);
+
+    c.start_us = now - (uint32_t)((uint32_t)now - tick);
+    c.sec_half = 0;
+    c.sec_us   = c.start_us;
+}
+
+// Count pushed at an edge -> edge time as us since boot plus the ns within
+// that us. The IRQ may run late by anything up to a counter wrap (~100 s at
+// 125 MHz); the wrap is resolved against the coarse time of handling.
+void pio_count_to_time(uint32_t x, uint64_t* edge_us, uint32_t* frac_ns)
+{
+    PioCapture& c = g_pio;
+    const uint32_t n_lo = 0u - x;   // ticks since start, mod 2^32
+
+    const uint64_t approx = mul_q32(time_us_64() - c.start_us, c.ticks_per_us_q32);
+    const uint64_t n = (((approx - n_lo + 0x80000000ULL) >> 32) << 32) | n_lo;
+
+    // Tick n's decrement runs 3(n-1) cycles after start and the pin is
+    // sampled one cycle later; the edge itself is on average 1.5 cycles
+    // before that sample, plus 2 cycles of input synchroniser.
+    // In half-cycles: 2 * delay + 6n - 11.
+    const uint64_t half = 2ull * START_DELAY_CYCLES + 6ull * n - 11ull;
+
+    // Move on to this edge's second. Normally that is one second on from
+    // the last edge and a 32-bit (hardware) divide; after a long PPS
+    // outage the gap is first walked in chunks that fit 32 bits.
+    uint64_t d = half - c.sec_half;
+    while (d >> 32) {
+        c.sec_half += c.chunk_half;
+        c.sec_us   += c.chunk_us;
+        d          -= c.chunk_half;
+    }
+    const uint32_t secs = (uint32_t)d / c.half_per_s;
+    const uint32_t rem  = (uint32_t)d - secs * c.half_per_s;
+    c.sec_half += (uint64_t)secs * c.half_per_s;
+    c.sec_us   += (uint64_t)secs * 1000000u;
+
+    const uint32_t ns = (uint32_t)mul_q32(rem, c.ns_per_half_q32);   // < 1e9
+    const uint32_t us = nsec_to_usec(ns);
+    *edge_us = c.sec_us + us;
+    *frac_ns = ns - us * 1000u;
+}
+
+void pio_irq_handler()
+{
+    PioCapture& c = g_pio;
+
+    // Autopush stalls the counter if the FIFO ever fills; its counts no
+    // longer line up with the timer, so start over on the next us tick.
+    const uint32_t stall = 1u << (PIO_FDEBUG_RXSTALL_LSB + c.sm);
+    if (c.pio->fdebug & stall) {
+        c.pio->fdebug = stall;
+        c.resyncs++;
+        pio_start_synced();
+        return;
+    }
+
+    while (!pio_sm_is_rx_fifo_empty(c.pio, c.sm)) {
+        uint64_t edge_us;
+        uint32_t frac_ns;
+        pio_count_to_time(pio_sm_get(c.pio, c.sm), &edge_us, &frac_ns);
+        pps_record_edge(edge_us, frac_ns);
+    }
+}
+
+bool pio_capture_init(uint32_t gpio)
+{
+    PioCapture& c = g_pio;
+    if (!pio_can_add_program(c.pio, &pps_capture_program)) return false;
+    c.sm = pio_claim_unused_sm(c.pio, false);
+    if (c.sm < 0) return false;
+
+    c.offset = pio_add_program(c.pio, &pps_capture_program);
+    c.sys_hz = clock_get_hz(clk_sys);
+    c.ticks_per_us_q32 = ((uint64_t)c.sys_hz << 32) / 3000000u;
+    c.half_per_s       = 2u * c.sys_hz;
+    c.ns_per_half_q32  = (1000000000ull << 32) / c.half_per_s;
+    const uint32_t chunk_s = 0xFFFFFFFFu / c.half_per_s;
+    c.chunk_half       = chunk_s * c.half_per_s;
+    c.chunk_us         = chunk_s * 1000000u;
+
+    pio_gpio_init(c.pio, gpio);
+    gpio_pull_down(gpio);
+    pio_sm_set_consecutive_pindirs(c.pio, c.sm, gpio, 1, false);
+
+    pio_sm_config cfg = pps_capture_program_get_default_config(c.offset);
+    sm_config_set_jmp_pin(&cfg, gpio);
+    sm_config_set_in_shift(&cfg, false, /*autopush=*/true, 32);
+    sm_config_set_fifo_join(&cfg, PIO_FIFO_JOIN_RX);   // 8 edges of slack
+    pio_sm_init(c.pio, c.sm, c.offset + pps_capture_offset_low, &cfg);
+
+    // RX-not-empty IRQ on the calling core; latency no longer matters.
+    irq_set_exclusive_handler(PIO0_IRQ_0, &pio_irq_handler);
+    pio_set_irq0_source_enabled(c.pio, (pio_interrupt_source)(pis_sm0_rx_fifo_not_empty + c.sm), true);
+    irq_set_enabled(PIO0_IRQ_0, true);
+
+    pio_start_synced();
+    return true;
+}
+
+} // namespace
+
+#endif // PPS_PIO
+
+static void pps_irq_callback(uint gpio, uint32_t events)
+{
+    (void)events;
+    if (gpio != g_pps_gpio) return;
+
+    pps_record_edge(time_us_64(), 0);
 }
 
 void pps_init(uint32_t gpio)
 {
     g_pps_gpio = gpio;
 
+#if PPS_PIO
+    if (pio_capture_init(g_pps_gpio)) {
+        std::printf("PPS: PIO CAPTURE ON GPIO%lu (%lu ns ticks)\r\n", (unsigned long)g_pps_gpio,
+                    (unsigned long)(3000000000ull / g_pio.sys_hz));
+        return;
+    }
+    std::printf("PPS: no free PIO state machine, falling back to IRQ\r\n");
+#endif
+
     gpio_init(g_pps_gpio);
     gpio_set_dir(g_pps_gpio, GPIO_IN);
     gpio_pull_down(g_pps_gpio);
@@ -43,8 +218,50 @@ void pps_init(uint32_t gpio)
     std::printf("PPS: IRQ ARMED ON GPIO%lu (RISING EDGE)\r\n", (unsigned long)g_pps_gpio);
 }
 
-uint32_t pps_get_edges() { return g_pps_edges; }
-uint32_t pps_get_last_interval_us() { return g_pps_last_interval_us; }
+bool pps_get_latest(PpsEdge* out)
+{
+    return out && g_pps_ring.read_latest(out, nullptr);
+}
+
+bool pps_get_edge(uint32_t seq, PpsEdge* out)
+{
+    return out && g_pps_ring.read(seq, out);
+}
+
+uint32_t pps_get_edges() { return g_pps_ring.head(); }
+
+uint32_t pps_get_last_interval_us()
+{
+    PpsEdge e;
+    return pps_get_latest(&e) ? e.interval_us : 0;
+}
+
+uint64_t pps_get_last_edge_us()
+{
+    PpsEdge e;
+    return pps_get_latest(&e) ? e.edge_us() : 0;
+}
 
-// NEW
-uint64_t pps_get_last_edge_us() { return g_pps_last_edge_us; }
+uint64_t pps_get_last_edge_ns()
+{
+    PpsEdge e;
+    return pps_get_latest(&e) ? e.edge_ns : 0;
+}
+
+bool pps_capture_is_pio()
+{
+#if PPS_PIO
+    return g_pio.sm >= 0;
+#else
+    return false;
+#endif
+}
+
+uint32_t pps_get_capture_resyncs()
+{
+#if PPS_PIO
+    return g_pio.resyncs;
+#else
+    return 0;
+#endif
+}
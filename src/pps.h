@@ -2,7 +2,44 @@
 #pragma once
 #include <cstdint>
 
+// 1: PPS edges latched by a PIO state machine against a system-clock
+// counter (set by CMake option PPS_PIO), 0: timestamped in the GPIO IRQ
+#ifndef PPS_PIO
+#define PPS_PIO 0
+#endif
+
+// One captured edge. Edges are numbered from 1 in capture order; the
+// newest one's number is also pps_get_edges().
+struct PpsEdge {
+    uint32_t seq         = 0;
+    uint32_t interval_us = 0;   // since the previous edge (0 for the first)
+
+    // time_us_64() timescale. With PIO capture this has ~24 ns resolution
+    // (3 clocks at 125 MHz) and no interrupt latency in it; with IRQ capture
+    // it is whole microseconds.
+    uint64_t edge_ns     = 0;
+
+    uint64_t edge_us() const { return edge_ns / 1000u; }
+};
+
+// Edges kept in the history ring; a reader that falls further behind than
+// this loses the oldest ones (pps_get_edge() returns false for them).
+constexpr uint32_t PPS_HISTORY = 16;
+
 void     pps_init(uint32_t gpio);
+
+// Newest edge, or by number while it is still in the ring. Each copy is
+// consistent (never mixes two edges); safe from either core.
+bool     pps_get_latest(PpsEdge* out);
+bool     pps_get_edge(uint32_t seq, PpsEdge* out);
+
+// Shorthands for fields of pps_get_latest() (0 before the first edge)
 uint32_t pps_get_edges();
 uint32_t pps_get_last_interval_us();
-uint64_t pps_get_last_edge_us();
\ No newline at end of file
+uint64_t pps_get_last_edge_us();
+uint64_t pps_get_last_edge_ns();
+
+// Which capture path is live, and how often the PIO counter had to be
+// restarted (RX FIFO overflow).
+bool     pps_capture_is_pio();
+uint32_t pps_get_capture_resyncs();
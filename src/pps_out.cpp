@@ -0,0 +1,466 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "pps_out.h"
+#include "int_math.h"
+#include "pps.h"
+#include "pps_stats.h"
+#include "snapshot.h"
+#include "timebase.h"
+
+#include "hardware/clocks.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "pico/platform.h"
+
+#include <cstdio>
+
+namespace {
+
+// A GPS edge further than this from an output pulse belongs to another second.
+constexpr int64_t  MATCH_NS      = 100000000LL;   // 100 ms
+// ... and one that hasn't shown up this long after the pulse isn't coming.
+constexpr uint64_t MATCH_WAIT_NS = 1100000000ULL;
+
+constexpr uint32_t READ_MAX_TRIES = 8;
+
+// One driven 1PPS edge, from the alarm IRQ to the GPS task.
+struct OutEdge {
+    uint32_t seq      = 0;
+    uint64_t unix_s   = 0;
+    uint64_t local_ns = 0;   // time_us_64() timescale
+};
+
+struct Match {
+    uint32_t seen    = 0;      // last OutEdge taken in
+    bool     pending = false;  // ... still waiting for its GPS edge
+    OutEdge  edge{};
+
+    int32_t  win[PPS_OUT_WIN]{};
+    uint32_t win_n   = 0;
+    uint32_t win_pos = 0;
+
+    PpsOutStats stats{};
+    SeqSnapshot<PpsOutStats> view;
+};
+
+Match g_match;
+
+// IRQ capture stamps an edge with the microsecond it fell in, so to the
+// timebase a local time means "during this microsecond": on average half a
+// microsecond after the tick. PIO capture stamps are already to the ns.
+inline uint32_t capture_center_ns() { return pps_capture_is_pio() ? 0u : 500u; }
+
+#if PPS_OUT
+
+SeqSnapshot<OutEdge> g_edge_view;   // writer: the pulse alarm IRQ
+
+// Each pulse is planned as soon as the previous one ends, planned again
+// REFINE_US before it on the newest model (the RMC for the previous second
+// usually lands in between and moves it), and approached from SPIN_US out
+// by spinning on the timer.
+constexpr uint64_t REFINE_US = 2000;
+constexpr uint64_t SPIN_US   = 10;
+
+// Without valid time, look again this often.
+constexpr uint64_t RETRY_US  = 250000;
+
+enum class Phase : uint8_t { Plan, Refine, Edge, Fall };
+
+struct PulseGen {
+    int      alarm   = -1;
+    Phase    phase   = Phase::Plan;
+    uint64_t unix_s  = 0;     // second being generated
+    uint64_t edge_us = 0;
+    uint32_t frac_ns = 0;     // below edge_us, placed by counting cycles
+    uint32_t cycles_per_us = 125;
+    uint32_t seq     = 0;
+
+    // IRQ-owned counters (read racily by the GPS task)
+    volatile uint32_t pulses  = 0;
+    volatile uint32_t late    = 0;
+    volatile uint32_t skipped = 0;
+};
+
+PulseGen g_pulse;
+
+// Local time (whole us + ns below) at which the timebase reads unix_s.
+bool second_to_local(uint64_t unix_s, uint64_t* us, uint32_t* frac_ns) {
+    if (!timebase_unix_to_local(unix_s, 0, us, frac_ns)) return false;
+    *frac_ns += capture_center_ns();
+    if (*frac_ns >= 1000u) {
+        *frac_ns -= 1000u;
+        *us += 1u;
+    }
+    return true;
+}
+
+// Locked, or holdover still inside its bound: what downstream gear may trust.
+bool time_valid() {
+    TimebaseQuality q;
+    return timebase_get_quality(&q) && q.leap == 0;
+}
+
+// False if t has already passed (the alarm won't fire).
+bool arm(int alarm, uint64_t t_us) {
+    return !hardware_alarm_set_target(static_cast<uint>(alarm), from_us_since_boot(t_us));
+}
+
+void pulse_arm(Phase phase, uint64_t t_us);
+
+// Pick the next second far enough out to refine, or retry later.
+void pulse_plan() {
+    PulseGen& g = g_pulse;
+    uint64_t s = 0;
+    uint32_t us = 0;
+    if (time_valid() && timebase_now_unix(&s, &us)) {
+        const uint64_t now = time_us_64();
+        for (uint64_t ahead = 1; ahead <= 2; ++ahead) {
+            if (!second_to_local(s + ahead, &g.edge_us, &g.frac_ns)) break;
+            if (g.edge_us < now + REFINE_US + SPIN_US) continue;
+            g.unix_s = s + ahead;
+            pulse_arm(Phase::Refine, g.edge_us - REFINE_US);
+            return;
+        }
+    }
+    pulse_arm(Phase::Plan, time_us_64() + RETRY_US);
+}
+
+// Drop the pulse in progress and plan the next.
+void pulse_skip() {
+    g_pulse.skipped++;
+    pulse_plan();
+}
+
+void pulse_arm(Phase phase, uint64_t t_us) {
+    PulseGen& g = g_pulse;
+    g.phase = phase;
+    if (arm(g.alarm, t_us)) return;
+
+    // Too late for this step (a long IRQ ahead of us).
+    if (phase == Phase::Fall) {
+        gpio_put(PPS_OUT_GPIO, 0);
+        pulse_plan();
+    } else if (phase == Phase::Plan) {
+        pulse_plan();
+    } else {
+        pulse_skip();
+    }
+}
+
+void pulse_edge() {
+    PulseGen& g = g_pulse;
+
+    // With PIO capture nothing else on this core is timing-critical, so the
+    // approach runs with interrupts off. With IRQ capture the GPS edge's own
+    // timestamp matters more: it may preempt the spin (our edge is then late).
+    const bool mask = pps_capture_is_pio();
+    uint32_t irq = mask ? save_and_disable_interrupts() : 0;
+    busy_wait_until(from_us_since_boot(g.edge_us));
+    if (!mask) irq = save_and_disable_interrupts();
+
+    const uint64_t now = time_us_64();
+    uint64_t edge_ns = 0;
+    if (now == g.edge_us) {
+        busy_wait_at_least_cycles(g.frac_ns * g.cycles_per_us / 1000u);
+        edge_ns = g.edge_us * 1000u + g.frac_ns;
+    } else {
+        g.late++;
+        edge_ns = now * 1000u;
+    }
+    gpio_put(PPS_OUT_GPIO, 1);
+    restore_interrupts(irq);
+
+    OutEdge e;
+    e.seq      = ++g.seq;
+    e.unix_s   = g.unix_s;
+    e.local_ns = edge_ns;
+    g_edge_view.publish(e);
+    g.pulses++;
+
+    pulse_arm(Phase::Fall, g.edge_us + PPS_OUT_WIDTH_MS * 1000ULL);
+}
+
+void pulse_alarm_cb(uint alarm_num) {
+    (void)alarm_num;
+    PulseGen& g = g_pulse;
+
+    switch (g.phase) {
+        case Phase::Plan:
+            pulse_plan();
+            break;
+        case Phase::Refine:
+            // The newest model, or nothing if time has gone bad since.
+            if (!time_valid() || !second_to_local(g.unix_s, &g.edge_us, &g.frac_ns)) {
+                pulse_skip();
+                break;
+            }
+            pulse_arm(Phase::Edge, g.edge_us - SPIN_US);
+            break;
+        case Phase::Edge:
+            pulse_edge();
+            break;
+        case Phase::Fall:
+            gpio_put(PPS_OUT_GPIO, 0);
+            pulse_plan();
+            break;
+    }
+}
+
+#if PPS_OUT_FREQ_HZ > 0
+
+static_assert(PPS_OUT_FREQ_HZ <= 10000, "square wave is alarm-driven, 10 kHz at most");
+
+// Square wave: edge k of a second (k = 0 .. 2f-1) at start + k * len / 2f,
+// high on even k. Each second's start and length come from the model a
+// second ahead, so the wave stays phase-locked to the 1PPS and its average
+// frequency is disciplined; single edges carry the alarm's IRQ latency.
+constexpr uint32_t FREQ_EDGES = 2u * PPS_OUT_FREQ_HZ;
+
+struct FreqGen {
+    int      alarm    = -1;
+    bool     idle     = true;
+    uint32_t k        = 0;     // edge the alarm is set for
+    uint64_t unix_s   = 0;
+    uint64_t start_ns = 0;     // local, this second
+    uint64_t len_ns   = 0;
+    bool     have_next = false;
+    uint64_t next_start_ns = 0;
+    uint64_t next_len_ns   = 0;
+
+    volatile uint32_t missed = 0;
+};
+
+FreqGen g_freq;
+
+bool freq_second(uint64_t unix_s, uint64_t* start_ns, uint64_t* len_ns) {
+    uint64_t a_us = 0, b_us = 0;
+    uint32_t a_ns = 0, b_ns = 0;
+    if (!time_valid() ||
+        !second_to_local(unix_s, &a_us, &a_ns) ||
+        !second_to_local(unix_s + 1u, &b_us, &b_ns)) {
+        return false;
+    }
+    *start_ns = a_us * 1000u + a_ns;
+    *len_ns   = b_us * 1000u + b_ns - *start_ns;
+    return true;
+}
+
+inline uint64_t freq_edge_us(const FreqGen& f, uint32_t k) {
+    return (f.start_ns + f.len_ns * k / FREQ_EDGES + 500u) / 1000u;
+}
+
+void freq_start() {
+    FreqGen& f = g_freq;
+    uint64_t s = 0;
+    uint32_t us = 0;
+    f.idle = true;
+    f.have_next = false;
+    if (timebase_now_unix(&s, &us)) {
+        const uint64_t now = time_us_64();
+        for (uint64_t ahead = 1; ahead <= 2; ++ahead) {
+            if (!freq_second(s + ahead, &f.start_ns, &f.len_ns)) break;
+            f.unix_s = s + ahead;
+            f.k = 0;
+            if (freq_edge_us(f, 0) > now && arm(f.alarm, freq_edge_us(f, 0))) {
+                f.idle = false;
+                return;
+            }
+        }
+    }
+    arm(f.alarm, time_us_64() + RETRY_US);
+}
+
+void freq_alarm_cb(uint alarm_num) {
+    (void)alarm_num;
+    FreqGen& f = g_freq;
+    if (f.idle) {
+        freq_start();
+        return;
+    }
+
+    gpio_put(PPS_OUT_FREQ_GPIO, (f.k & 1u) == 0);
+    if (f.k == 0) f.have_next = freq_second(f.unix_s + 1u, &f.next_start_ns, &f.next_len_ns);
+
+    // Next edge, skipping any whose time has already gone.
+    while (true) {
+        if (++f.k == FREQ_EDGES) {
+            if (!f.have_next) {
+                // Time went bad: stop low and start over once it's back.
+                gpio_put(PPS_OUT_FREQ_GPIO, 0);
+                f.idle = true;
+                arm(f.alarm, time_us_64() + RETRY_US);
+                return;
+            }
+            f.unix_s++;
+            f.start_ns  = f.next_start_ns;
+            f.len_ns    = f.next_len_ns;
+            f.have_next = false;
+            f.k = 0;
+        }
+        if (arm(f.alarm, freq_edge_us(f, f.k))) return;
+        f.missed++;
+    }
+}
+
+#endif // PPS_OUT_FREQ_HZ > 0
+
+int claim_alarm(hardware_alarm_callback_t cb) {
+    const int alarm = hardware_alarm_claim_unused(false);
+    if (alarm < 0) return -1;
+    hardware_alarm_set_callback(static_cast<uint>(alarm), cb);
+    // See pulse_edge(): with IRQ capture the PPS interrupt must be able to
+    // preempt the spin.
+    if (!pps_capture_is_pio()) {
+        irq_set_priority(hardware_alarm_get_irq_num(static_cast<uint>(alarm)), PICO_LOWEST_IRQ_PRIORITY);
+    }
+    return alarm;
+}
+
+void init_output(uint32_t gpio) {
+    gpio_init(gpio);
+    gpio_set_dir(gpio, GPIO_OUT);
+    gpio_put(gpio, 0);
+}
+
+// Output - GPS error of one pulse into the window.
+void record_error(int64_t err_ns) {
+    Match& m = g_match;
+    PpsOutStats& st = m.stats;
+    if (err_ns >  INT32_MAX) err_ns = INT32_MAX;
+    if (err_ns < -INT32_MAX) err_ns = -INT32_MAX;
+
+    m.win[m.win_pos] = static_cast<int32_t>(err_ns);
+    m.win_pos = (m.win_pos + 1u) % PPS_OUT_WIN;
+    if (m.win_n < PPS_OUT_WIN) m.win_n++;
+
+    int64_t sum = 0;
+    uint64_t sq = 0, worst = 0;
+    for (uint32_t i = 0; i < m.win_n; ++i) {
+        const int64_t v = m.win[i];
+        sum += v;
+        sq  += static_cast<uint64_t>(v * v);
+        if (static_cast<uint64_t>(abs64(v)) > worst) worst = static_cast<uint64_t>(abs64(v));
+    }
+
+    st.matched++;
+    st.last_unix_s = m.edge.unix_s;
+    st.last_err_ns = static_cast<int32_t>(err_ns);
+    st.win_n       = m.win_n;
+    st.mean_ns     = static_cast<int32_t>(sum / static_cast<int64_t>(m.win_n));
+    st.rms_ns      = static_cast<uint32_t>(isqrt64(sq / m.win_n));
+    st.max_abs_ns  = static_cast<uint32_t>(worst);
+}
+
+// Pair the pending pulse with the GPS edge captured nearest to it (the one
+// that follows, if the output runs early). False while it may still come.
+bool try_match(uint64_t now_ns) {
+    Match& m = g_match;
+    const uint64_t out_ns = m.edge.local_ns;
+
+    const uint32_t head = pps_get_edges();
+    for (uint32_t back = 0; back < PPS_HISTORY && back < head; ++back) {
+        const uint32_t seq = head - back;
+        PpsEdge e;
+        if (!pps_get_edge(seq, &e)) break;
+        if (e.edge_ns + static_cast<uint64_t>(MATCH_NS) < out_ns) break;   // older ones are further still
+
+        const PpsVerdict v = pps_stats_verdict(seq);
+        if (v == PpsVerdict::Outlier || v == PpsVerdict::Extra) continue;
+
+        const int64_t err = static_cast<int64_t>(out_ns - (e.edge_ns + capture_center_ns()));
+        if (abs64(err) <= MATCH_NS) {
+            record_error(err);
+            return true;
+        }
+    }
+
+    if (now_ns > out_ns + MATCH_WAIT_NS) {
+        m.stats.unmatched++;
+        return true;
+    }
+    return false;
+}
+
+#endif // PPS_OUT
+
+} // namespace
+
+void pps_out_init() {
+    g_match.view.publish(g_match.stats);
+
+#if PPS_OUT
+    PulseGen& g = g_pulse;
+    g.cycles_per_us = clock_get_hz(clk_sys) / 1000000u;
+    g.alarm = claim_alarm(&pulse_alarm_cb);
+    if (g.alarm < 0) {
+        std::printf("PPS OUT: no free hardware alarm\r\n");
+        return;
+    }
+    init_output(PPS_OUT_GPIO);
+
+#if PPS_OUT_FREQ_HZ > 0
+    g_freq.alarm = claim_alarm(&freq_alarm_cb);
+    if (g_freq.alarm >= 0) {
+        init_output(PPS_OUT_FREQ_GPIO);
+        arm(g_freq.alarm, time_us_64() + RETRY_US);
+        g_match.stats.freq_hz = PPS_OUT_FREQ_HZ;
+    } else {
+        std::printf("PPS OUT: no free hardware alarm for %lu Hz\r\n", (unsigned long)PPS_OUT_FREQ_HZ);
+    }
+#endif
+
+    g_match.stats.running = true;
+    g_match.view.publish(g_match.stats);
+    pulse_arm(Phase::Plan, time_us_64() + RETRY_US);
+
+    std::printf("PPS OUT: GPIO%lu, %lu ms pulses\r\n", (unsigned long)PPS_OUT_GPIO,
+                (unsigned long)PPS_OUT_WIDTH_MS);
+#endif
+}
+
+void pps_out_service() {
+#if PPS_OUT
+    Match& m = g_match;
+    PpsOutStats& st = m.stats;
+    bool changed = false;
+
+    OutEdge e;
+    if (g_edge_view.read(&e, READ_MAX_TRIES) && e.seq != m.seen) {
+        if (m.pending) st.unmatched++;   // overtaken before it could be paired
+        m.seen    = e.seq;
+        m.edge    = e;
+        m.pending = true;
+        changed   = true;
+    }
+    if (m.pending && try_match(time_us_64() * 1000u)) {
+        m.pending = false;
+        changed   = true;
+    }
+    if (!changed) return;
+
+    st.pulses  = g_pulse.pulses;
+    st.late    = g_pulse.late;
+    st.skipped = g_pulse.skipped;
+#if PPS_OUT_FREQ_HZ > 0
+    st.freq_missed = g_freq.missed;
+#endif
+    m.view.publish(st);
+#endif
+}
+
+bool pps_out_get(PpsOutStats* out) {
+    if (!out) return false;
+    return g_match.view.read(out, READ_MAX_TRIES);
+}
@@ -0,0 +1,76 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <cstdint>
+
+// Disciplined 1PPS output generated from the timebase (CMake option PPS_OUT).
+//
+// A PPS_OUT_WIDTH_MS pulse on PPS_OUT_GPIO starts at every whole UTC second
+// of the timebase model, and optionally a PPS_OUT_FREQ_HZ square wave on
+// PPS_OUT_FREQ_GPIO rises on the second and every 1/f after it. Both are
+// scheduled on hardware alarms from timebase_unix_to_local(), not echoed
+// from the GPS pulse, and only run while the timebase advertises valid
+// time (locked, or in holdover inside its error bound).
+//
+// Every output pulse is paired with the GPS PPS edge captured nearest to
+// it, and the difference is logged as the output's time error.
+
+#ifndef PPS_OUT
+#define PPS_OUT 0
+#endif
+#ifndef PPS_OUT_GPIO
+#define PPS_OUT_GPIO 20
+#endif
+#ifndef PPS_OUT_WIDTH_MS
+#define PPS_OUT_WIDTH_MS 100
+#endif
+// 0 = off; up to 10 kHz (one alarm interrupt per half period)
+#ifndef PPS_OUT_FREQ_HZ
+#define PPS_OUT_FREQ_HZ 0
+#endif
+#ifndef PPS_OUT_FREQ_GPIO
+#define PPS_OUT_FREQ_GPIO 21
+#endif
+
+// Error statistics cover this many of the latest matched pulses.
+constexpr uint32_t PPS_OUT_WIN = 64;
+
+struct PpsOutStats {
+    bool     running   = false;   // alarms claimed, generator armed
+    uint32_t freq_hz   = 0;       // square wave, 0 = none
+
+    uint32_t pulses    = 0;       // 1PPS edges driven
+    uint32_t late      = 0;       // ... that missed their microsecond (preempted)
+    uint32_t skipped   = 0;       // seconds left out: no valid time
+    uint32_t freq_missed = 0;     // square-wave edges whose alarm came too late
+
+    // Output edge - GPS edge (+ = output late)
+    uint32_t matched   = 0;
+    uint32_t unmatched = 0;       // no GPS edge within reach
+    uint64_t last_unix_s = 0;     // second of the last matched pulse
+    int32_t  last_err_ns = 0;
+    uint32_t win_n     = 0;
+    int32_t  mean_ns   = 0;
+    uint32_t rms_ns    = 0;       // about zero, not the mean
+    uint32_t max_abs_ns = 0;
+};
+
+// GPS task, after pps_init(). Claims the alarms (on the calling core) and
+// starts the generator; no-op unless PPS_OUT.
+void pps_out_init();
+
+// GPS task: pair new output pulses with captured GPS edges.
+void pps_out_service();
+
+// Latest published statistics; safe from either core.
+bool pps_out_get(PpsOutStats* out);
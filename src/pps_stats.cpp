@@ -0,0 +1,253 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "pps_stats.h"
+#include "int_math.h"
+#include "pps.h"
+#include "snapshot.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr int64_t NSEC_PER_SEC = 1000000000LL;
+
+// Further than this from the expected whole-second grid the edge isn't a
+// late or early PPS, it's a different pulse.
+constexpr int64_t EXTRA_NS = 100000000LL;   // 100 ms
+
+// Until the filter has FILTER_MIN_N samples, accept anything within the
+// servo's frequency range of the grid (1000 ppm).
+constexpr uint32_t FILTER_MIN_N = 8;
+constexpr int64_t  BOOT_TOL_NS  = 1000000LL;
+
+// Tolerance: OUTLIER_SIGMA robust standard deviations (1.4826 * MAD), but
+// never below TOL_FLOOR_NS, so 1 us capture quantization (MAD of 0) can't
+// make the filter reject the next +-1 us tick.
+constexpr uint32_t OUTLIER_SIGMA = 6;
+constexpr int64_t  TOL_FLOOR_NS  = 3000;
+
+// This many on-grid rejections in a row means the reference (or the pulse
+// train) has moved; restart from the newest edge.
+constexpr uint32_t RESYNC_RUN = 4;
+
+// A median interval further than this from 1 s isn't a PPS we can lock to.
+constexpr int64_t LOCK_MAX_DEV_NS = 1000000LL;   // 1000 ppm
+
+// Readers give up after this many torn reads (see snapshot.h).
+constexpr uint32_t READ_MAX_TRIES = 8;
+
+struct State {
+    uint32_t cursor = 0;        // last edge classified
+
+    bool     have_ref = false;  // last accepted edge
+    uint64_t ref_ns   = 0;
+    uint32_t reject_run = 0;
+
+    int32_t  win[PPS_STATS_LONG]{};   // accepted 1 s intervals, ns from 1 s
+    uint32_t win_n   = 0;
+    uint32_t win_pos = 0;       // next write
+
+    PpsVerdict verdict[PPS_HISTORY]{};
+    uint32_t   verdict_seq[PPS_HISTORY]{};
+
+    PpsStats stats{};
+    SeqSnapshot<PpsStats> view;
+};
+
+State g_ps;
+
+// Summary of the newest n samples of the window.
+void window_stats(uint32_t n, PpsWindowStats* w) {
+    *w = PpsWindowStats{};
+    if (n > g_ps.win_n) n = g_ps.win_n;
+    if (n == 0) return;
+
+    int64_t sum = 0;
+    int32_t lo = INT32_MAX, hi = INT32_MIN;
+    for (uint32_t i = 0; i < n; ++i) {
+        const int32_t v = g_ps.win[(g_ps.win_pos + PPS_STATS_LONG - 1u - i) % PPS_STATS_LONG];
+        sum += v;
+        lo = std::min(lo, v);
+        hi = std::max(hi, v);
+    }
+    const int64_t mean = sum / static_cast<int64_t>(n);
+
+    uint64_t sq = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        const int64_t d = g_ps.win[(g_ps.win_pos + PPS_STATS_LONG - 1u - i) % PPS_STATS_LONG] - mean;
+        sq += static_cast<uint64_t>(d * d);
+    }
+
+    w->n       = n;
+    w->mean_ns = static_cast<int32_t>(mean);
+    w->std_ns  = static_cast<uint32_t>(isqrt64(sq / n));
+    w->min_ns  = lo;
+    w->max_ns  = hi;
+}
+
+// Median and MAD of the long window (at most 64 samples, once a second).
+void refresh_filter() {
+    PpsStats& st = g_ps.stats;
+    const uint32_t n = g_ps.win_n;
+    st.filter_ready = n >= FILTER_MIN_N;
+    if (n == 0) return;
+
+    int32_t tmp[PPS_STATS_LONG];
+    std::copy(g_ps.win, g_ps.win + n, tmp);
+    std::nth_element(tmp, tmp + n / 2, tmp + n);
+    const int32_t med = tmp[n / 2];
+
+    for (uint32_t i = 0; i < n; ++i) tmp[i] = static_cast<int32_t>(abs64(int64_t{g_ps.win[i]} - med));
+    std::nth_element(tmp, tmp + n / 2, tmp + n);
+    const uint32_t mad = static_cast<uint32_t>(tmp[n / 2]);
+
+    // 1.4826 ~= 1483 / 1000
+    const int64_t tol = static_cast<int64_t>(mad) * 1483 * OUTLIER_SIGMA / 1000;
+
+    st.median_ns = med;
+    st.mad_ns    = mad;
+    st.tol_ns    = static_cast<uint32_t>(std::max(tol, TOL_FLOOR_NS));
+}
+
+void add_sample(int64_t dev_ns) {
+    g_ps.win[g_ps.win_pos] = static_cast<int32_t>(dev_ns);
+    g_ps.win_pos = (g_ps.win_pos + 1u) % PPS_STATS_LONG;
+    if (g_ps.win_n < PPS_STATS_LONG) g_ps.win_n++;
+
+    refresh_filter();
+    window_stats(PPS_STATS_SHORT, &g_ps.stats.short_win);
+    window_stats(PPS_STATS_LONG,  &g_ps.stats.long_win);
+}
+
+void set_verdict(uint32_t seq, PpsVerdict v) {
+    g_ps.verdict[seq % PPS_HISTORY]     = v;
+    g_ps.verdict_seq[seq % PPS_HISTORY] = seq;
+}
+
+void accept(const PpsEdge& e) {
+    PpsStats& st = g_ps.stats;
+    g_ps.have_ref   = true;
+    g_ps.ref_ns     = e.edge_ns;
+    g_ps.reject_run = 0;
+    st.accepted++;
+    st.last_accepted = true;
+    st.last_good_us  = e.edge_us();
+    set_verdict(e.seq, PpsVerdict::Accepted);
+}
+
+void classify(const PpsEdge& e) {
+    PpsStats& st = g_ps.stats;
+    st.edges++;
+
+    if (!g_ps.have_ref || e.edge_ns <= g_ps.ref_ns) {
+        accept(e);
+        return;
+    }
+
+    // Whole seconds since the reference, and how far off that grid we are
+    // (net of the oscillator offset the window has measured).
+    const int64_t dt  = static_cast<int64_t>(e.edge_ns - g_ps.ref_ns);
+    const int64_t k   = (dt + NSEC_PER_SEC / 2) / NSEC_PER_SEC;
+    const int64_t raw = dt - k * NSEC_PER_SEC;
+    const int64_t exp = st.filter_ready ? k * st.median_ns : 0;
+    const int64_t tol = st.filter_ready ? k * static_cast<int64_t>(st.tol_ns) : BOOT_TOL_NS * (k ? k : 1);
+    const int64_t dev = raw - exp;
+
+    if (k == 0 || abs64(dev) > EXTRA_NS) {
+        // Reference stays put: the real pulse is still to come.
+        st.extra++;
+        set_verdict(e.seq, PpsVerdict::Extra);
+        return;
+    }
+
+    if (abs64(dev) > tol) {
+        st.outliers++;
+        st.last_accepted = false;
+        set_verdict(e.seq, PpsVerdict::Outlier);
+        if (++g_ps.reject_run >= RESYNC_RUN) {
+            // Relearn from scratch too, in case the interval itself moved.
+            st.resyncs++;
+            g_ps.win_n   = 0;
+            g_ps.win_pos = 0;
+            st.filter_ready = false;
+            st.short_win = PpsWindowStats{};
+            st.long_win  = PpsWindowStats{};
+            accept(e);
+        }
+        return;
+    }
+
+    if (k == 1) add_sample(raw);
+    else        st.missing += static_cast<uint32_t>(k - 1);
+    accept(e);
+}
+
+} // namespace
+
+void pps_stats_init() {
+    // Untrained, from the next edge captured.
+    g_ps.cursor     = pps_get_edges();
+    g_ps.have_ref   = false;
+    g_ps.ref_ns     = 0;
+    g_ps.reject_run = 0;
+    g_ps.win_n      = 0;
+    g_ps.win_pos    = 0;
+    std::fill(g_ps.verdict, g_ps.verdict + PPS_HISTORY, PpsVerdict::Unknown);
+    std::fill(g_ps.verdict_seq, g_ps.verdict_seq + PPS_HISTORY, 0u);
+    g_ps.stats = PpsStats{};
+    g_ps.view.publish(g_ps.stats);
+}
+
+void pps_stats_service() {
+    const uint32_t head = pps_get_edges();
+    if (head == g_ps.cursor) return;
+
+    PpsStats& st = g_ps.stats;
+    if (head - g_ps.cursor > PPS_HISTORY) {
+        // Fell behind the ring: the gap isn't missing pulses, so start over.
+        st.lost += head - g_ps.cursor - PPS_HISTORY;
+        g_ps.cursor  = head - PPS_HISTORY;
+        g_ps.have_ref = false;
+    }
+
+    while (g_ps.cursor != head) {
+        const uint32_t seq = ++g_ps.cursor;
+        PpsEdge e;
+        if (!pps_get_edge(seq, &e)) {
+            st.lost++;
+            g_ps.have_ref = false;
+            continue;
+        }
+        classify(e);
+    }
+
+    g_ps.view.publish(st);
+}
+
+PpsVerdict pps_stats_verdict(uint32_t seq) {
+    if (seq == 0 || g_ps.verdict_seq[seq % PPS_HISTORY] != seq) return PpsVerdict::Unknown;
+    return g_ps.verdict[seq % PPS_HISTORY];
+}
+
+bool pps_stats_healthy(uint64_t now_us, uint64_t stale_us) {
+    PpsStats st;
+    if (!pps_stats_get(&st)) return false;
+    if (!st.filter_ready || !st.last_accepted || st.last_good_us == 0) return false;
+    if (abs64(st.median_ns) > LOCK_MAX_DEV_NS) return false;
+    return now_us >= st.last_good_us && now_us - st.last_good_us <= stale_us;
+}
+
+bool pps_stats_get(PpsStats* out) {
+    if (!out) return false;
+    return g_ps.view.read(out, READ_MAX_TRIES);
+}
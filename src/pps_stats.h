@@ -0,0 +1,82 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <cstdint>
+
+// Streaming statistics over the PPS edge stream.
+//
+// Every captured edge is classified against the last accepted one: a pulse
+// far off the 1 s grid is "extra", a gap of several seconds counts the
+// pulses "missing" in between, and an on-grid edge whose interval strays
+// from the window median by more than a MAD-derived tolerance is an
+// "outlier". Accepted 1 s intervals feed two rolling windows (mean, std,
+// min, max) and the median/MAD that set the tolerance.
+//
+// Runs in the GPS task (pps_stats_service() drains the edge ring); the
+// published PpsStats can be read from either core.
+
+// Rolling windows, in accepted 1 s intervals. The long one also holds the
+// samples behind the median/MAD filter.
+constexpr uint32_t PPS_STATS_SHORT = 16;
+constexpr uint32_t PPS_STATS_LONG  = 64;
+
+// Interval deviations are in ns from a nominal 1 s (+ = interval longer,
+// i.e. the local timer is fast).
+struct PpsWindowStats {
+    uint32_t n       = 0;
+    int32_t  mean_ns = 0;
+    uint32_t std_ns  = 0;
+    int32_t  min_ns  = 0;
+    int32_t  max_ns  = 0;
+};
+
+struct PpsStats {
+    uint32_t edges    = 0;   // edges classified
+    uint32_t accepted = 0;   // ... that passed the filter
+    uint32_t outliers = 0;   // on the grid but outside the tolerance
+    uint32_t extra    = 0;   // off the grid entirely (glitches, double pulses)
+    uint32_t missing  = 0;   // pulses absent from gaps between accepted edges
+    uint32_t lost     = 0;   // overwritten in the ring before they were read
+    uint32_t resyncs  = 0;   // reference moved after a run of rejections
+
+    PpsWindowStats short_win{};
+    PpsWindowStats long_win{};
+
+    int32_t  median_ns = 0;   // long window
+    uint32_t mad_ns    = 0;
+    uint32_t tol_ns    = 0;   // acceptance half-width around the median
+
+    bool     filter_ready  = false;   // enough samples for median/MAD
+    bool     last_accepted = false;   // newest on-grid edge passed (extras aside)
+    uint64_t last_good_us  = 0;       // newest accepted edge (time_us_64())
+};
+
+enum class PpsVerdict : uint8_t { Unknown = 0, Accepted, Outlier, Extra };
+
+// Start over, untrained, from the next captured edge.
+void pps_stats_init();
+
+// Classify edges captured since the last call. GPS task only.
+void pps_stats_service();
+
+// Verdict on edge `seq` while it is within the last PPS_HISTORY edges
+// (Unknown otherwise, or if not classified yet). GPS task only.
+PpsVerdict pps_stats_verdict(uint32_t seq);
+
+// PPS is present and behaving: an accepted edge within stale_us of now_us,
+// no outlier since, a trained filter and a plausible median interval.
+// Used for GPS "Locked".
+bool pps_stats_healthy(uint64_t now_us, uint64_t stale_us);
+
+// Latest published statistics; safe from either core.
+bool pps_stats_get(PpsStats* out);
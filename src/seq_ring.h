@@ -0,0 +1,84 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// History ring of the last N records from one writer (typically an IRQ),
+// each tagged with a sequence number 1, 2, 3, ... Readers on either core
+// fetch any record still in the ring by its number; a per-slot seqlock
+// tells a clean copy from one the writer overwrote mid-read. Neither side
+// waits or disables interrupts.
+//
+// Unlike SeqSnapshot, nothing is lost between reads as long as a reader
+// keeps up within N records. T must be trivially copyable; N a power of two.
+// Sequence numbers wrap after 2^32 records, which never happens at 1 Hz.
+
+template <typename T, uint32_t N>
+class SeqRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two");
+
+public:
+    // Writer only. Returns the new record's sequence number.
+    uint32_t push(const T& v) {
+        const uint32_t seq = head_.load(std::memory_order_relaxed) + 1u;
+        Slot& slot = slots_[seq & (N - 1)];
+
+        slot.seq.store(0u, std::memory_order_relaxed);   // 0 = being written
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.val = v;
+
+        slot.seq.store(seq, std::memory_order_release);
+        head_.store(seq, std::memory_order_release);
+        return seq;
+    }
+
+    // Sequence number of the newest record (0 = none yet).
+    uint32_t head() const { return head_.load(std::memory_order_acquire); }
+
+    // Copy record `seq`. False if it hasn't been pushed yet, or was (or is
+    // being) overwritten by a newer one.
+    bool read(uint32_t seq, T* out) const {
+        if (seq == 0) return false;
+        const Slot& slot = slots_[seq & (N - 1)];
+
+        if (slot.seq.load(std::memory_order_acquire) != seq) return false;
+        *out = slot.val;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.seq.load(std::memory_order_relaxed) == seq;
+    }
+
+    // Newest record and its number. Only fails if the writer laps the
+    // reader max_tries times in a row, or there is nothing yet.
+    bool read_latest(T* out, uint32_t* seq_out, uint32_t max_tries = 8) const {
+        for (uint32_t tries = 0; tries < max_tries; ++tries) {
+            const uint32_t seq = head();
+            if (seq == 0) return false;
+            if (read(seq, out)) {
+                if (seq_out) *seq_out = seq;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> seq{0};   // record held, 0 while empty or being written
+        T val{};
+    };
+
+    Slot slots_[N];
+    std::atomic<uint32_t> head_{0};
+};
@@ -0,0 +1,226 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "servo.h"
+#include "int_math.h"
+
+namespace {
+
+constexpr uint64_t USEC_PER_SEC = 1000000ULL;
+constexpr uint64_t NSEC_PER_SEC = 1000000000ULL;
+
+// FLL: measure frequency over this many PPS seconds before closing the loop.
+constexpr uint64_t FLL_SECONDS = 8;
+
+// Any PPS interval further than this from nominal is not our oscillator.
+constexpr uint64_t MAX_SKEW_US_PER_SEC = 1000;   // 1000 ppm
+
+// Hard limit on the learned frequency correction.
+constexpr int64_t MAX_FREQ_Q32 = 2147484;       // ~500 ppm
+
+// Phase errors beyond this are treated as outliers (bad label, glitch).
+// Several in a row means the model is really off and we step.
+constexpr int64_t  STEP_THRESHOLD_NS = 1000000; // 1 ms
+constexpr uint32_t SPIKE_LIMIT       = 3;
+
+// "Locked" = this many consecutive updates within the window.
+constexpr int64_t  LOCK_WINDOW_NS = 10000;      // 10 us
+constexpr uint32_t LOCK_COUNT     = 8;
+
+// PI loop gains as right shifts, applied once per PPS second:
+// the phase term removes 1/4 of the error per second, the integral
+// term folds 1/32 of it into the frequency.
+constexpr int KP_SHIFT = 2;
+constexpr int KI_SHIFT = 5;
+
+inline int64_t clamp_freq(int64_t f) {
+    if (f >  MAX_FREQ_Q32) return  MAX_FREQ_Q32;
+    if (f < -MAX_FREQ_Q32) return -MAX_FREQ_Q32;
+    return f;
+}
+
+// ns error accumulated over one second -> fractional frequency (2^-32 units)
+// 2^32 / 1e9 = 4.294967296 ~= 281475 / 65536
+inline int64_t ns_per_sec_to_q32(int64_t ns) {
+    return (ns * 281475) / 65536;
+}
+
+// Local elapsed time must match the labeled seconds to within MAX_SKEW.
+inline bool interval_plausible(uint64_t local_us, uint64_t seconds) {
+    const uint64_t nominal = seconds * USEC_PER_SEC;
+    const uint64_t slack   = seconds * MAX_SKEW_US_PER_SEC;
+    const uint64_t diff = (local_us > nominal) ? (local_us - nominal) : (nominal - local_us);
+    return diff <= slack;
+}
+
+// unix_s begins frac_ns after edge_us, so edge_us itself is that much earlier.
+void step_to(Servo* s, uint64_t edge_us, uint32_t frac_ns, uint64_t unix_s) {
+    s->model.ref_local_us = edge_us;
+    s->model.ref_unix_s   = (frac_ns != 0) ? unix_s - 1 : unix_s;
+    s->model.ref_ns       = (frac_ns != 0) ? static_cast<uint32_t>(NSEC_PER_SEC - frac_ns) : 0;
+    s->model.rate_q32     = s->freq_q32;
+}
+
+void start_fll(Servo* s, uint64_t edge_us, uint32_t frac_ns, uint64_t unix_s) {
+    step_to(s, edge_us, frac_ns, unix_s);
+    s->steps++;
+    s->state       = ServoState::Fll;
+    s->fll_edge_us = edge_us;
+    s->fll_edge_ns = frac_ns;
+    s->fll_unix_s  = unix_s;
+    s->good_count  = 0;
+    s->spike_count = 0;
+}
+
+// Phase error of the current model at a labeled edge (+ = model ahead).
+int64_t model_offset_ns(const ServoModel* m, uint64_t edge_us, uint64_t unix_s) {
+    uint64_t ms = 0;
+    uint32_t mns = 0;
+    servo_model_eval(m, edge_us, &ms, &mns);
+    return static_cast<int64_t>(ms - unix_s) * static_cast<int64_t>(NSEC_PER_SEC)
+         + static_cast<int64_t>(mns);
+}
+
+} // namespace
+
+void servo_init(Servo* s) {
+    if (!s) return;
+    *s = Servo{};
+}
+
+bool servo_on_edge(Servo* s, uint64_t edge_us, uint32_t frac_ns, uint64_t unix_s) {
+    if (!s || edge_us == 0) return false;
+
+    if (s->state != ServoState::Unset) {
+        // Same edge / same second twice, or going backwards: ignore.
+        if (edge_us <= s->last_edge_us || unix_s <= s->last_unix_s) return false;
+    }
+
+    switch (s->state) {
+        case ServoState::Unset:
+            start_fll(s, edge_us, frac_ns, unix_s);
+            break;
+
+        case ServoState::Fll: {
+            const uint64_t n     = unix_s - s->fll_unix_s;
+            const uint64_t local = edge_us - s->fll_edge_us;
+
+            if (!interval_plausible(local, n)) {
+                // Label and edge disagree (missed sentence, wrong second): start over.
+                start_fll(s, edge_us, frac_ns, unix_s);
+                break;
+            }
+
+            s->last_offset_ns = model_offset_ns(&s->model, edge_us, unix_s) + frac_ns;
+            if (n < FLL_SECONDS) break;
+
+            // local timer counted `local_ns` while `n` true seconds elapsed
+            const int64_t local_ns = static_cast<int64_t>(local * 1000u + frac_ns) - s->fll_edge_ns;
+            const int64_t diff_ns  = static_cast<int64_t>(n * NSEC_PER_SEC) - local_ns;
+            // (diff / local) << 32, split 22 + 10 so long gaps can't overflow
+            s->freq_q32 = clamp_freq((diff_ns * (1LL << 22)) / (local_ns >> 10));
+
+            // Re-anchor on this edge with the measured rate and close the loop.
+            step_to(s, edge_us, frac_ns, unix_s);
+            s->state = ServoState::Pll;
+            s->good_count = 0;
+            break;
+        }
+
+        case ServoState::Pll: {
+            // The model runs on for frac_ns past edge_us before the true edge.
+            const int64_t err_ns = model_offset_ns(&s->model, edge_us, unix_s) + frac_ns;
+            s->last_offset_ns = err_ns;
+
+            if (abs64(err_ns) > STEP_THRESHOLD_NS) {
+                s->good_count = 0;
+                if (++s->spike_count < SPIKE_LIMIT) return false;
+                start_fll(s, edge_us, frac_ns, unix_s);
+                break;
+            }
+            s->spike_count = 0;
+
+            const int64_t n = static_cast<int64_t>(unix_s - s->last_unix_s);
+            const int64_t err_q32 = ns_per_sec_to_q32(err_ns);
+
+            // Integral: frequency error is the phase error spread over n seconds.
+            s->freq_q32 = clamp_freq(s->freq_q32 - (err_q32 >> KI_SHIFT) / n);
+
+            // Re-anchor at the edge where the model currently puts it, so time
+            // stays continuous, then slew the phase out via a temporary rate.
+            servo_reanchor(s, edge_us);
+            s->model.rate_q32 = clamp_freq(s->freq_q32 - (err_q32 >> KP_SHIFT));
+
+            s->good_count = (abs64(err_ns) <= LOCK_WINDOW_NS) ? (s->good_count + 1) : 0;
+            break;
+        }
+    }
+
+    s->last_edge_us = edge_us;
+    s->last_unix_s  = unix_s;
+    s->updates++;
+    return true;
+}
+
+void servo_coarse(Servo* s, uint64_t arrival_us, uint64_t unix_s) {
+    if (!s || arrival_us == 0) return;
+
+    // A sentence for second N arrives some time during second N, so a model
+    // that still agrees puts the arrival inside [N, N+1).
+    if (s->state != ServoState::Unset || s->steps != 0) {
+        uint64_t ms = 0;
+        uint32_t mns = 0;
+        servo_model_eval(&s->model, arrival_us, &ms, &mns);
+        if (ms == unix_s) return;
+    }
+
+    step_to(s, arrival_us, 0, unix_s);
+    s->steps++;
+    s->state       = ServoState::Unset;
+    s->good_count  = 0;
+    s->spike_count = 0;
+}
+
+void servo_holdover(Servo* s, uint64_t local_us, int64_t freq_adj_q32) {
+    if (!s || s->state == ServoState::Unset) return;
+
+    servo_reanchor(s, local_us);
+    s->model.rate_q32 = clamp_freq(s->freq_q32 + freq_adj_q32);
+}
+
+bool servo_is_locked(const Servo* s) {
+    return s && s->state == ServoState::Pll && s->good_count >= LOCK_COUNT;
+}
+
+int32_t servo_freq_ppb(const Servo* s) {
+    if (!s) return 0;
+    return static_cast<int32_t>((s->freq_q32 * 1000000000LL) / 4294967296LL);
+}
+
+void servo_reanchor(Servo* s, uint64_t local_us) {
+    if (!s || local_us <= s->model.ref_local_us) return;
+
+    uint64_t us = 0;
+    uint32_t ns = 0;
+    servo_model_eval(&s->model, local_us, &us, &ns);
+    s->model.ref_local_us = local_us;
+    s->model.ref_unix_s   = us;
+    s->model.ref_ns       = ns;
+}
+
+void servo_model_eval(const ServoModel* m, uint64_t local_us,
+                      uint64_t* unix_s, uint32_t* ns) {
+    const uint64_t total_ns = m->ref_ns + servo_model_elapsed_ns(m, local_us);
+
+    *unix_s = m->ref_unix_s + total_ns / NSEC_PER_SEC;
+    *ns     = static_cast<uint32_t>(total_ns % NSEC_PER_SEC);
+}
@@ -0,0 +1,109 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <cstdint>
+
+// PPS clock discipline (FLL acquisition, then a PI phase-locked loop).
+//
+// Pure integer logic with no Pico SDK dependencies, so it can be driven on a
+// host build with a synthetic edge stream. All local times are the 1 MHz
+// time_us_64() counter; all UTC times are Unix seconds + nanoseconds.
+
+enum class ServoState : uint8_t {
+    Unset = 0,  // no model yet
+    Fll,        // stepped onto PPS, measuring frequency
+    Pll,        // phase-locked, slewing only
+};
+
+inline const char* servo_state_str(ServoState s) {
+    switch (s) {
+        case ServoState::Unset: return "UNSET";
+        case ServoState::Fll:   return "FLL";
+        case ServoState::Pll:   return "PLL";
+    }
+    return "?";
+}
+
+// Linear map from the local microsecond counter to UTC.
+//   utc(local) = ref_utc + (local - ref_local_us) * (1 + rate)
+// rate is a fractional frequency correction in 2^-32 units.
+struct ServoModel {
+    uint64_t ref_local_us = 0;
+    uint64_t ref_unix_s   = 0;
+    uint32_t ref_ns       = 0;  // [0, 1e9)
+    int64_t  rate_q32     = 0;
+};
+
+struct Servo {
+    ServoState state = ServoState::Unset;
+    ServoModel model{};
+
+    // Learned oscillator correction (without the transient phase term).
+    int64_t freq_q32 = 0;
+
+    // FLL start point / last accepted labeled edge
+    uint64_t fll_edge_us   = 0;
+    uint32_t fll_edge_ns   = 0;   // sub-us part of fll_edge_us
+    uint64_t fll_unix_s    = 0;
+    uint64_t last_edge_us  = 0;
+    uint64_t last_unix_s   = 0;
+
+    // Diagnostics
+    int64_t  last_offset_ns = 0;   // model - PPS at last edge (+ = we were ahead)
+    uint32_t good_count     = 0;   // consecutive in-tolerance PLL updates
+    uint32_t spike_count    = 0;   // consecutive rejected outliers
+    uint32_t steps          = 0;   // total phase steps (including the first)
+    uint32_t updates        = 0;   // total accepted edges
+};
+
+void servo_init(Servo* s);
+
+// Feed a PPS edge (local us, plus frac_ns [0, 1000) when the capture has
+// sub-us resolution) together with the UTC second it marks.
+// Returns true if the edge was accepted (not a duplicate / outlier).
+bool servo_on_edge(Servo* s, uint64_t edge_us, uint32_t frac_ns, uint64_t unix_s);
+
+// Coarse fallback when no PPS edge is available: anchor the model to the
+// time a sentence for unix_s arrived. Only steps (and drops out of FLL/PLL)
+// when the current model disagrees with that second; keeps the learned rate.
+void servo_coarse(Servo* s, uint64_t arrival_us, uint64_t unix_s);
+
+// PPS lost: re-anchor at local_us and run on the learned frequency plus
+// freq_adj_q32 (e.g. a temperature correction), dropping the transient
+// phase-slew term. May be called again during holdover to update the
+// adjustment; freq_q32 itself is left alone. The next accepted edge resumes
+// normal discipline.
+void servo_holdover(Servo* s, uint64_t local_us, int64_t freq_adj_q32);
+
+// True once the PLL has held the phase inside its lock window for a while.
+bool servo_is_locked(const Servo* s);
+
+// Learned frequency correction in parts per billion (+ = local timer is slow).
+int32_t servo_freq_ppb(const Servo* s);
+
+// Move the model's reference point to local_us without changing the time it
+// produces, so readers only ever see short deltas.
+void servo_reanchor(Servo* s, uint64_t local_us);
+
+// Evaluate a model at a local timestamp. Local times before ref are clamped.
+void servo_model_eval(const ServoModel* m, uint64_t local_us,
+                      uint64_t* unix_s, uint32_t* ns);
+
+// Rate-corrected nanoseconds elapsed since the model's reference point
+// (not including ref_ns). Multiplies only; the rate term is split so dt up
+// to ~50 days fits in 64 bits.
+inline uint64_t servo_model_elapsed_ns(const ServoModel* m, uint64_t local_us) {
+    const uint64_t dt_us = (local_us > m->ref_local_us) ? (local_us - m->ref_local_us) : 0;
+    const int64_t corr_ns = (((static_cast<int64_t>(dt_us) * m->rate_q32) >> 12) * 1000) >> 20;
+    return dt_us * 1000ULL + static_cast<uint64_t>(corr_ns);
+}
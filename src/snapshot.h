@@ -0,0 +1,66 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Double-buffered seqlock for publishing a small struct from one writer to
+// any number of readers (the other core, or an IRQ that preempted the
+// writer). The writer always fills the slot readers are NOT pointed at and
+// then flips `active`, so readers never wait and never disable interrupts;
+// a read only retries if the writer lapped it twice during one copy.
+//
+// T must be trivially copyable. Single writer only.
+
+template <typename T>
+class SeqSnapshot {
+public:
+    void publish(const T& v) {
+        const uint32_t idx = active_.load(std::memory_order_relaxed) ^ 1u;
+        Slot& slot = slots_[idx];
+
+        const uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+        slot.seq.store(seq + 1u, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.val = v;
+
+        slot.seq.store(seq + 2u, std::memory_order_release);
+        active_.store(idx, std::memory_order_release);
+    }
+
+    // Returns false after max_tries torn reads; *retries (if given) counts them.
+    bool read(T* out, uint32_t max_tries = 8, volatile uint32_t* retries = nullptr) const {
+        for (uint32_t tries = 0; tries < max_tries; ++tries) {
+            const Slot& slot = slots_[active_.load(std::memory_order_acquire)];
+
+            const uint32_t s1 = slot.seq.load(std::memory_order_acquire);
+            if ((s1 & 1u) == 0) {
+                *out = slot.val;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.seq.load(std::memory_order_relaxed) == s1) return true;
+            }
+            if (retries) *retries = *retries + 1u;
+        }
+        return false;
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> seq{0};   // odd while being written
+        T val{};
+    };
+
+    Slot slots_[2];
+    std::atomic<uint32_t> active_{0};
+};
@@ -0,0 +1,143 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "stability.h"
+#include "snapshot.h"
+
+#include <cmath>
+
+namespace {
+
+// Phase history: MDEV at tau = m needs x[n - 3m] .. x[n].
+constexpr uint32_t TAU_MAX_S  = 1u << (STABILITY_TAUS - 1u);
+constexpr uint32_t PHASE_RING = 2048;
+static_assert(PHASE_RING >= 3u * TAU_MAX_S + 1u && (PHASE_RING & (PHASE_RING - 1u)) == 0,
+              "phase ring must cover 3 * tau_max and be a power of two");
+
+// Clamp so a sample fits the int32 ring (only matters before the servo has
+// pulled in, and those seconds aren't fed here anyway).
+constexpr int64_t PHASE_CLAMP_NS = 2000000000LL;
+
+constexpr uint32_t READ_MAX_TRIES = 8;
+
+// Running sums for one tau = m seconds, over second differences
+//   d = x[i + 2m] - 2 x[i + m] + x[i]
+// (ADEV) and sums of m consecutive d's (MDEV).
+struct Accum {
+    int64_t  s      = 0;     // sum of the newest m d's
+    double   sum_d2 = 0.0;   // ns^2
+    double   sum_s2 = 0.0;
+    uint32_t n_d    = 0;
+    uint32_t n_s    = 0;
+};
+
+struct State {
+    int32_t  x[PHASE_RING]{};   // ns, indexed by sample number
+    uint32_t n = 0;             // samples taken
+    uint32_t run = 0;           // contiguous samples ending at the newest
+    uint32_t gaps = 0;
+    uint64_t last_unix_s = 0;
+
+    Accum acc[STABILITY_TAUS]{};
+
+    SeqSnapshot<StabilityReport> view;
+};
+
+State g_st;
+
+// Phase k samples before the newest.
+inline int64_t x_back(uint32_t k) {
+    return g_st.x[(g_st.n - 1u - k) & (PHASE_RING - 1u)];
+}
+
+void publish() {
+    StabilityReport r{};
+    r.samples = g_st.n;
+    r.gaps    = g_st.gaps;
+    r.run_s   = g_st.run;
+
+    for (uint32_t i = 0; i < STABILITY_TAUS; ++i) {
+        const Accum& a = g_st.acc[i];
+        StabilityPoint& p = r.pt[i];
+        const double m = static_cast<double>(1u << i);   // tau in s, tau0 = 1 s
+
+        p.tau_s  = 1u << i;
+        p.n_adev = a.n_d;
+        p.n_mdev = a.n_s;
+        if (a.n_d) {
+            // ADEV^2 = <d^2> / (2 tau^2)
+            p.adev = static_cast<float>(std::sqrt(a.sum_d2 / (2.0 * a.n_d)) / m * 1e-9);
+        }
+        if (a.n_s) {
+            // MDEV^2 = <s^2> / (2 m^2 tau^2), TDEV = tau / sqrt(3) * MDEV
+            const double rms = std::sqrt(a.sum_s2 / (2.0 * a.n_s));
+            p.mdev    = static_cast<float>(rms / (m * m) * 1e-9);
+            p.tdev_ns = static_cast<float>(rms / (m * std::sqrt(3.0)));
+        }
+    }
+    g_st.view.publish(r);
+}
+
+} // namespace
+
+void stability_reset() {
+    g_st.n = 0;
+    g_st.run = 0;
+    g_st.gaps = 0;
+    g_st.last_unix_s = 0;
+    for (Accum& a : g_st.acc) a = Accum{};
+    publish();
+}
+
+void stability_add(uint64_t unix_s, int64_t phase_ns) {
+    if (g_st.n != 0 && unix_s <= g_st.last_unix_s) return;
+
+    if (g_st.n != 0 && unix_s != g_st.last_unix_s + 1u) {
+        // Differences can't span the hole; restart them, keep the sums.
+        g_st.gaps++;
+        g_st.run = 0;
+        for (Accum& a : g_st.acc) a.s = 0;
+    }
+    g_st.last_unix_s = unix_s;
+
+    if (phase_ns >  PHASE_CLAMP_NS) phase_ns =  PHASE_CLAMP_NS;
+    if (phase_ns < -PHASE_CLAMP_NS) phase_ns = -PHASE_CLAMP_NS;
+    g_st.x[g_st.n & (PHASE_RING - 1u)] = static_cast<int32_t>(phase_ns);
+    g_st.n++;
+    g_st.run++;
+
+    const uint32_t run = g_st.run;
+    for (uint32_t i = 0; i < STABILITY_TAUS; ++i) {
+        const uint32_t m = 1u << i;
+        if (run < 2u * m + 1u) break;   // longer taus need even more
+
+        Accum& a = g_st.acc[i];
+        const int64_t d = x_back(0) - 2 * x_back(m) + x_back(2u * m);
+        a.sum_d2 += static_cast<double>(d) * static_cast<double>(d);
+        a.n_d++;
+
+        // Slide the m-long window of d's: drop the one from m samples ago.
+        a.s += d;
+        if (run >= 3u * m + 1u) a.s -= x_back(m) - 2 * x_back(2u * m) + x_back(3u * m);
+        if (run >= 3u * m) {
+            a.sum_s2 += static_cast<double>(a.s) * static_cast<double>(a.s);
+            a.n_s++;
+        }
+    }
+
+    publish();
+}
+
+bool stability_get(StabilityReport* out) {
+    if (!out) return false;
+    return g_st.view.read(out, READ_MAX_TRIES);
+}
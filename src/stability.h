@@ -0,0 +1,51 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <cstdint>
+
+// Allan (ADEV), modified Allan (MDEV) and time deviation (TDEV) of the
+// disciplined clock, from its phase error at each PPS edge (the servo's
+// offset, one sample per second while it is locked).
+//
+// Fully overlapping estimators at octave-spaced tau = 1, 2, 4 ... s, updated
+// incrementally as each sample arrives: only the last 3 * tau_max phase
+// samples are kept, plus running sums per tau, so memory is fixed however
+// long it runs. A missing second breaks the phase record; the sums carry on
+// and the differences restart after the gap.
+
+constexpr uint32_t STABILITY_TAUS = 10;   // 1 .. 512 s
+
+struct StabilityPoint {
+    uint32_t tau_s   = 0;
+    uint32_t n_adev  = 0;      // second differences averaged
+    uint32_t n_mdev  = 0;      // ... and their tau-long sums
+    float    adev    = 0.0f;   // fractional frequency
+    float    mdev    = 0.0f;
+    float    tdev_ns = 0.0f;   // tau / sqrt(3) * MDEV
+};
+
+struct StabilityReport {
+    uint32_t samples = 0;      // phase samples taken
+    uint32_t gaps    = 0;      // breaks in the 1 s record
+    uint32_t run_s   = 0;      // contiguous seconds up to the newest sample
+    StabilityPoint pt[STABILITY_TAUS]{};   // pt[i].tau_s = 2^i
+};
+
+void stability_reset();
+
+// Phase error (ns, + = clock ahead) of the edge marking unix_s. Samples
+// must come in time order; a jump in unix_s counts as a gap. Writer only.
+void stability_add(uint64_t unix_s, int64_t phase_ns);
+
+// Latest published estimates; safe from either core.
+bool stability_get(StabilityReport* out);
@@ -35,6 +35,10 @@ namespace {
     };
 
     EmaState g_ema{};
+
+    // Published EMA for readers on the other core (single aligned words)
+    volatile int32_t g_temp_mc    = 0;
+    volatile bool    g_temp_valid = false;
 } // namespace
 
 void temp_init()
@@ -86,3 +90,19 @@ float temp_ema_update_throttled(float sample_c)
     return g_ema.ema_c;
 }
 
+
+void temp_service()
+{
+    if (g_ema.inited && time_us_64() - g_ema.last_update_us < MIN_UPDATE_US) return;
+
+    const float c = temp_ema_update_throttled(read_temp_c());
+    g_temp_mc    = static_cast<int32_t>(::lroundf(c * 1000.0f));
+    g_temp_valid = true;
+}
+
+bool temp_get_mc(int32_t* out_mc)
+{
+    if (!out_mc || !g_temp_valid) return false;
+    *out_mc = g_temp_mc;
+    return true;
+}
@@ -11,8 +11,17 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #pragma once
+#include <cstdint>
 
 void temp_init();
 float read_temp_c();
 float temp_ema_update_throttled(float sample_c);
 
+// Sample the sensor (throttled) and publish the smoothed value. Call from
+// the loop that owns the ADC (the GPS task).
+void temp_service();
+
+// Last smoothed temperature in milli-degrees C, readable from either core.
+// Returns false before the first sample.
+bool temp_get_mc(int32_t* out_mc);
+
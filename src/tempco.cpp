@@ -0,0 +1,163 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "tempco.h"
+
+#include <cmath>
+
+namespace {
+
+// A bin is a plain mean until it has this many samples, then an EMA with
+// weight 1/BIN_MAX_N so aging slowly replaces old readings.
+constexpr uint16_t BIN_MAX_N = 64;
+
+// Bins with fewer samples than this are left out of the fit.
+constexpr uint16_t BIN_MIN_N = 4;
+
+// Temperature span the used bins must cover before fitting a slope, and
+// before adding curvature. A quadratic over a narrow span extrapolates badly.
+constexpr float LINEAR_MIN_SPAN_C    = 2.0f;
+constexpr float QUADRATIC_MIN_SPAN_C = 6.0f;
+
+// Residual mean square: EMA weight per sample
+constexpr float RESID_ALPHA = 1.0f / 32.0f;
+
+inline float bin_center_c(uint32_t i) {
+    return static_cast<float>(TEMPCO_MIN_C) + static_cast<float>(i) + 0.5f;
+}
+
+inline float eval(const Tempco* tc, float t_c) {
+    if (t_c < tc->t_lo) t_c = tc->t_lo;
+    if (t_c > tc->t_hi) t_c = tc->t_hi;
+    const float x = t_c - tc->t_ref;
+    return tc->c0 + x * (tc->c1 + x * tc->c2);
+}
+
+inline double det3(double a, double b, double c,
+                   double d, double e, double f,
+                   double g, double h, double i) {
+    return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+}
+
+// Weighted least squares over the populated bins. Runs once per sample
+// (every few seconds at most), so double precision is affordable.
+void refit(Tempco* tc) {
+    double sw = 0.0, swt = 0.0;
+    float lo = 0.0f, hi = 0.0f;
+    uint8_t used = 0;
+
+    for (uint32_t i = 0; i < TEMPCO_BINS; ++i) {
+        const TempcoBin& b = tc->bins[i];
+        if (b.n < BIN_MIN_N) continue;
+        const float t = bin_center_c(i);
+        if (used == 0) lo = t;
+        hi = t;
+        sw  += b.n;
+        swt += b.n * static_cast<double>(t);
+        used++;
+    }
+
+    tc->bins_used = used;
+    if (used == 0) {
+        tc->order = 0;
+        return;
+    }
+
+    // Centre on the weighted mean temperature to keep the sums well scaled.
+    const double t_ref = swt / sw;
+    double s[5] = {};   // sum w x^k
+    double r[3] = {};   // sum w x^k y
+    for (uint32_t i = 0; i < TEMPCO_BINS; ++i) {
+        const TempcoBin& b = tc->bins[i];
+        if (b.n < BIN_MIN_N) continue;
+        const double x = bin_center_c(i) - t_ref;
+        const double w = b.n;
+        double xk = w;
+        for (int k = 0; k < 5; ++k) {
+            s[k] += xk;
+            if (k < 3) r[k] += xk * b.ppb;
+            xk *= x;
+        }
+    }
+
+    const float span = hi - lo;
+    double c0 = r[0] / s[0], c1 = 0.0, c2 = 0.0;
+    uint8_t order = 0;
+
+    if (used >= 3 && span >= QUADRATIC_MIN_SPAN_C) {
+        const double d = det3(s[0], s[1], s[2], s[1], s[2], s[3], s[2], s[3], s[4]);
+        if (d != 0.0) {
+            c0 = det3(r[0], s[1], s[2], r[1], s[2], s[3], r[2], s[3], s[4]) / d;
+            c1 = det3(s[0], r[0], s[2], s[1], r[1], s[3], s[2], r[2], s[4]) / d;
+            c2 = det3(s[0], s[1], r[0], s[1], s[2], r[1], s[2], s[3], r[2]) / d;
+            order = 2;
+        }
+    }
+    if (order == 0 && used >= 2 && span >= LINEAR_MIN_SPAN_C) {
+        const double d = s[0] * s[2] - s[1] * s[1];
+        if (d != 0.0) {
+            c0 = (r[0] * s[2] - r[1] * s[1]) / d;
+            c1 = (s[0] * r[1] - s[1] * r[0]) / d;
+            order = 1;
+        }
+    }
+
+    // A constant alone can't predict a change with temperature.
+    tc->order = order;
+    tc->c0    = static_cast<float>(c0);
+    tc->c1    = static_cast<float>(c1);
+    tc->c2    = static_cast<float>(c2);
+    tc->t_ref = static_cast<float>(t_ref);
+    tc->t_lo  = lo;
+    tc->t_hi  = hi;
+}
+
+} // namespace
+
+void tempco_init(Tempco* tc) {
+    if (!tc) return;
+    *tc = Tempco{};
+}
+
+void tempco_add(Tempco* tc, int32_t temp_mc, int32_t freq_ppb) {
+    if (!tc) return;
+
+    const int32_t bin = (temp_mc >= 0 ? temp_mc : temp_mc - 999) / 1000 - TEMPCO_MIN_C;
+    if (bin < 0 || bin >= static_cast<int32_t>(TEMPCO_BINS)) return;
+
+    const float actual = static_cast<float>(freq_ppb);
+    float pred = 0.0f;
+    if (tempco_predict(tc, temp_mc, &pred)) {
+        const float e = pred - actual;
+        tc->resid_ms += RESID_ALPHA * (e * e - tc->resid_ms);
+        tc->last_pred_ppb = pred;
+    }
+    tc->last_actual_ppb = actual;
+    tc->samples++;
+
+    TempcoBin& b = tc->bins[bin];
+    if (b.n < BIN_MAX_N) b.n++;
+    b.ppb += (actual - b.ppb) / static_cast<float>(b.n);
+
+    refit(tc);
+}
+
+bool tempco_predict(const Tempco* tc, int32_t temp_mc, float* ppb) {
+    if (!tc || !ppb || tc->order == 0) return false;
+    *ppb = eval(tc, static_cast<float>(temp_mc) * 0.001f);
+    return true;
+}
+
+float tempco_resid_rms_ppb(const Tempco* tc) {
+    if (!tc || tc->resid_ms <= 0.0f) return 0.0f;
+    return ::sqrtf(tc->resid_ms);
+}
@@ -0,0 +1,59 @@
+/*
+ * Pico NTP Server (RP2040 / Pico SDK)
+ * Copyright (c) 2026 <Timothy J Millea>.
+ *
+ * Liability / Warranty Disclaimer:
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <cstdint>
+
+// Oscillator frequency vs. die temperature, learned while PPS-locked.
+//
+// Each sample (smoothed temperature, servo frequency correction) lands in a
+// 1 C bin holding a slow running mean; a weighted least-squares polynomial
+// (linear, then quadratic once the bins span enough range) is refitted over
+// the bins after every sample. Like servo.h this is pure logic with no SDK
+// dependencies; the caller supplies both inputs.
+
+constexpr int32_t  TEMPCO_MIN_C = -20;
+constexpr uint32_t TEMPCO_BINS  = 100;   // -20 .. +80 C
+
+struct TempcoBin {
+    float    ppb = 0.0f;   // mean frequency correction in this bin
+    uint16_t n   = 0;      // samples (saturates; older ones fade out)
+};
+
+struct Tempco {
+    TempcoBin bins[TEMPCO_BINS]{};
+
+    // ppb(T) = c0 + c1 * (T - t_ref) + c2 * (T - t_ref)^2, T in C.
+    // Only evaluated inside [t_lo, t_hi]; beyond that the edge value holds.
+    uint8_t order = 0;     // 0 = no fit yet, 1 = linear, 2 = quadratic
+    float   c0 = 0.0f, c1 = 0.0f, c2 = 0.0f;
+    float   t_ref = 0.0f, t_lo = 0.0f, t_hi = 0.0f;
+    uint8_t bins_used = 0;
+
+    // Fit vs. servo at each new sample, evaluated before the sample is added.
+    uint32_t samples         = 0;
+    float    last_pred_ppb   = 0.0f;
+    float    last_actual_ppb = 0.0f;
+    float    resid_ms        = 0.0f;   // running mean square of (pred - actual)
+};
+
+void tempco_init(Tempco* tc);
+
+// Add a locked sample: smoothed temperature (milli-C) and the servo's
+// learned frequency correction (ppb). Refits the curve.
+void tempco_add(Tempco* tc, int32_t temp_mc, int32_t freq_ppb);
+
+// Curve at temp_mc. Returns false while there is no usable fit.
+bool tempco_predict(const Tempco* tc, int32_t temp_mc, float* ppb);
+
+// RMS of the prediction residuals seen so far (0 before any).
+float tempco_resid_rms_ppb(const Tempco* tc);
@@ -11,49 +11,490 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "timebase.h"
+#include "servo.h"
+#include "int_math.h"
+#include "pps.h"
+#include "pps_stats.h"
+#include "snapshot.h"
+#include "stability.h"
+#include "tempco.h"
+#include "temp.h"
 
 #include "pico/time.h"
-#include "hardware/sync.h"
 
 namespace {
 
-constexpr uint32_t USEC_PER_SEC = 1000000u;
 constexpr uint64_t NTP_UNIX_EPOCH_DELTA = 2208988800ULL; // 1900->1970
+constexpr uint64_t NSEC_PER_SEC = 1000000000ULL;
+
+// The writer re-anchors at least once per second (timebase_service()), so the
+// read path normally sees < 2 s of elapsed time. Beyond this it falls back to
+// the dividing evaluation rather than looping.
+constexpr uint64_t FAST_EVAL_MAX_NS = 4ULL * NSEC_PER_SEC;
+
+// How far past the model's reference timebase_unix_to_local() reaches. The
+// reference may trail now by a few seconds while an edge awaits its label.
+constexpr uint64_t UNIX_TO_LOCAL_MAX_S = 16;
+
+// Re-anchor/publish period when no PPS/RMC update has done it for us.
+constexpr uint64_t REFRESH_US = 1000000ULL;
+
+// An RMC for second N is only paired with a PPS edge that happened less than
+// this long before the sentence was handled (L76: PPS leads NMEA by ~100-500 ms).
+constexpr uint64_t RMC_PPS_MAX_LAG_US = 950000ULL;
+
+// PPS must have been seen this recently for the timebase to count as synced
+// (one missing pulse is ridden out on the model).
+constexpr uint64_t PPS_STALE_US = 2500000ULL;
+
+// An edge whose RMC never arrived is still fed to the servo when the next
+// labeled edge follows within this many seconds, labeled by counting whole
+// seconds back, provided the spacing is that many seconds to within
+// PPS_LABEL_TOL_NS_PER_S (2x the servo's frequency range).
+constexpr uint32_t PPS_BACKFILL_MAX_S     = 4;
+constexpr uint64_t PPS_LABEL_TOL_NS_PER_S = 2000000ULL;
+
+// Reply precision: the worse of the 1 us timer tick and the cost of one
+// timestamp read, measured once (log2 s, rounded to nearest).
+constexpr int8_t   TIMER_PRECISION = -20;   // 2^-20 s ~= 1 us
+constexpr uint64_t TIMER_RES_NS    = 1000;
+constexpr uint32_t PRECISION_READS = 64;
+
+// PPS jitter: mean |offset| over PLL edges, EMA weight 1/2^JITTER_SHIFT
+constexpr int JITTER_SHIFT = 3;
+
+// Holdover error model: the error while locked (precision + PPS jitter),
+// then a residual frequency error and a linear frequency drift
+// (temperature, aging) integrated over the outage:
+//   bound(t) = e0 + FREQ_ERR * t + DRIFT * t^2 / 2
+constexpr uint64_t HOLDOVER_FREQ_ERR_PPB      = 50;
+constexpr uint64_t HOLDOVER_DRIFT_PPB_PER_H   = 200;
+
+// Advertised quality vs. the error bound: stratum 1 while it is this tight,
+// stratum 2 up to HOLDOVER_MAX_NS, then LI alarm / stratum 16.
+constexpr uint64_t HOLDOVER_STRATUM1_NS = 100000ULL;      // 100 us (~20 min)
+constexpr uint64_t HOLDOVER_MAX_NS      = 10000000ULL;    // 10 ms (~5 h)
+
+// Time from sentence arrival alone is late by up to the NMEA latency.
+constexpr uint64_t COARSE_DISP_NS = NSEC_PER_SEC;
+// RFC 5905 MAXDISP (16 s): "don't use me"
+constexpr uint64_t MAX_DISP_NS    = 16ULL * NSEC_PER_SEC;
+
+// Temperature model: one locked sample per this long. The servo's frequency
+// estimate and the temperature EMA both move on a ~30 s scale.
+constexpr uint64_t TEMPCO_SAMPLE_US = 16000000ULL;
+
+// Readers give up after this many torn reads (only possible if the writer
+// publishes twice while one reader is stalled mid-copy).
+constexpr uint32_t READ_MAX_TRIES = 8;
+
+// What a timestamp read needs, published as one unit. Kept small: every
+// NTP reply copies it twice.
+struct Snapshot {
+    ServoModel model{};
+    uint32_t   ref_ntp_s = 0;       // model.ref_unix_s in NTP era-0 seconds (cached)
+    bool       have_time = false;
+    bool       synced    = false;   // PLL locked on PPS
+
+    // Last PPS edge the servo accepted (or one awaiting a backfilled label),
+    // so readers on the other core can check PPS liveness without going
+    // through the edge ring.
+    uint64_t   pps_edge_us    = 0;
+};
 
 struct TimebaseState {
-    // Baseline: UTC unix seconds at baseline, and "snapped" local microsecond counter
-    uint64_t base_unix = 0;
-    uint64_t base_us   = 0;
-
-    bool have_time = false;
-
-    // For now, treat "synced" as "have_time" (tighten later when PPS is used)
-    bool synced = false;
+    // Writer-only state (RMC/PPS path, single writer)
+    Servo    servo{};
+    uint32_t pps_seq         = 0;   // newest PPS edge handed to the servo
+    uint64_t pending_edge_us = 0;   // unlabeled edge that can still be backfilled
+
+    // Reader views; safe to read from either core. Timestamps and reply
+    // header fields are read per packet, status only by the UI.
+    SeqSnapshot<Snapshot>        view;
+    SeqSnapshot<TimebaseQuality> quality_view;
+    SeqSnapshot<TimebaseStatus>  status_view;
+
+    uint64_t last_publish_us = 0;
+    bool     have_time = false;
+    bool     synced    = false;
+
+    // Holdover: the servo was locked and PPS went away. Runs on the learned
+    // frequency from the last locked edge until the bound runs out or the
+    // servo starts over.
+    bool     have_lock          = false;
+    bool     holdover           = false;
+    uint64_t holdover_start_us  = 0;   // last locked PPS edge
+    uint64_t lock_error_ns      = 0;   // e0 of the error model
+
+    // Inputs to the advertised quality
+    int8_t   precision          = TIMER_PRECISION;
+    uint64_t precision_ns       = TIMER_RES_NS;
+    bool     precision_measured = false;
+    uint64_t jitter_ns          = 0;
+    bool     have_jitter        = false;
+    uint64_t ref_unix_s         = 0;   // last discipline update (0 = never)
+    uint32_t ref_ns             = 0;
+
+    // Frequency vs. temperature, learned while locked and applied on top of
+    // the learned frequency in holdover.
+    Tempco   tempco{};
+    uint64_t tc_last_sample_us  = 0;
+    bool     hold_have_temp     = false;
+    int32_t  hold_temp_mc       = 0;   // at holdover entry
+    int64_t  hold_adj_q32       = 0;   // correction currently in the model
+    uint64_t hold_adj_us        = 0;   // ... in effect since here
+    int64_t  hold_adj_ns        = 0;   // phase added by earlier corrections
+    TimebaseTempco tc_recovery{};      // recovery_* fields only
+
+    // Diagnostics: approximate (racy increments from several readers are fine)
+    volatile uint32_t read_retries = 0;
 
-    // crude but effective protection
-    spin_lock_t* lock = nullptr;
-    uint32_t lock_num = 0;
     bool inited = false;
 };
 
 TimebaseState g_tb;
 
-inline uint32_t lock_tb() {
-    // Assumes timebase_init() was called once at boot.
-    return spin_lock_blocking(g_tb.lock);
+bool read_snapshot(Snapshot* out) {
+    if (!g_tb.inited) return false;
+    return g_tb.view.read(out, READ_MAX_TRIES, &g_tb.read_retries);
+}
+
+// Newest PPS edge that counts for liveness. An edge whose RMC went missing
+// counts while the next RMC can still label it.
+inline uint64_t pps_live_edge_us() {
+    return (g_tb.pending_edge_us > g_tb.servo.last_edge_us) ? g_tb.pending_edge_us
+                                                            : g_tb.servo.last_edge_us;
+}
+
+// ns -> NTP short format (16.16 s), rounded up: 2^16 / 1e9 ~= 281475 / 2^32
+inline uint32_t ns_to_ntp_short(uint64_t ns) {
+    if (ns > MAX_DISP_NS) ns = MAX_DISP_NS;
+    return static_cast<uint32_t>((ns * 281475ULL) >> 32) + 1u;
+}
+
+// Phase (ns) a rate offset of adj_q32 adds over dt_us; same split as
+// servo_model_elapsed_ns().
+inline int64_t adj_phase_ns(int64_t adj_q32, uint64_t dt_us) {
+    return (((static_cast<int64_t>(dt_us) * adj_q32) >> 12) * 1000) >> 20;
+}
+
+// Writer side: one locked sample into the temperature model.
+void learn_tempco(uint64_t edge_us) {
+    if (edge_us - g_tb.tc_last_sample_us < TEMPCO_SAMPLE_US) return;
+
+    int32_t t_mc = 0;
+    if (!temp_get_mc(&t_mc)) return;
+    g_tb.tc_last_sample_us = edge_us;
+    tempco_add(&g_tb.tempco, t_mc, servo_freq_ppb(&g_tb.servo));
+}
+
+// Writer side, in holdover: re-anchor at anchor_us with the frequency change
+// the curve predicts between the lock temperature and now. Only the change
+// is applied, so an offset in the fit (aging since it was learned) cancels.
+void apply_tempco(uint64_t anchor_us) {
+    if (anchor_us > g_tb.hold_adj_us) {
+        g_tb.hold_adj_ns += adj_phase_ns(g_tb.hold_adj_q32, anchor_us - g_tb.hold_adj_us);
+        g_tb.hold_adj_us  = anchor_us;
+    }
+
+    int64_t adj_q32 = 0;
+    int32_t t_mc = 0;
+    float now_ppb = 0.0f, lock_ppb = 0.0f;
+    if (g_tb.hold_have_temp && temp_get_mc(&t_mc) &&
+        tempco_predict(&g_tb.tempco, t_mc, &now_ppb) &&
+        tempco_predict(&g_tb.tempco, g_tb.hold_temp_mc, &lock_ppb)) {
+        // ppb -> 2^-32 units
+        adj_q32 = static_cast<int64_t>((now_ppb - lock_ppb) * 4.294967296f);
+    }
+    g_tb.hold_adj_q32 = adj_q32;
+    servo_holdover(&g_tb.servo, anchor_us, adj_q32);
+}
+
+// Writer side: the first labeled edge after holdover measures how far the
+// model drifted, with and without the temperature correction.
+void record_recovery(uint64_t edge_us) {
+    int64_t adj_ns = g_tb.hold_adj_ns;
+    if (edge_us > g_tb.hold_adj_us) adj_ns += adj_phase_ns(g_tb.hold_adj_q32, edge_us - g_tb.hold_adj_us);
+
+    TimebaseTempco& r = g_tb.tc_recovery;
+    r.have_recovery      = true;
+    r.recovery_after_s   = static_cast<uint32_t>((edge_us - g_tb.holdover_start_us) / 1000000ULL);
+    r.recovery_err_ns    = g_tb.servo.last_offset_ns;
+    r.recovery_uncomp_ns = g_tb.servo.last_offset_ns - adj_ns;   // + = model ahead
+}
+
+// Writer side: enter/leave holdover. anchor_us is where the model may be
+// re-anchored (not past an unlabeled PPS edge).
+void update_holdover(bool synced, uint64_t anchor_us) {
+    if (synced) {
+        g_tb.have_lock     = true;
+        g_tb.holdover      = false;
+        g_tb.lock_error_ns = g_tb.precision_ns + g_tb.jitter_ns;
+        return;
+    }
+    if (!g_tb.have_lock) return;
+
+    if (g_tb.servo.state != ServoState::Pll) {
+        // Stepped or re-acquiring: nothing left to hold over from.
+        g_tb.have_lock = false;
+        g_tb.holdover  = false;
+        return;
+    }
+    if (!g_tb.holdover) {
+        // Lock lost with PPS still arriving (a noisy edge): the PLL keeps steering.
+        if (pps_live_edge_us() + PPS_STALE_US >= anchor_us) return;
+
+        g_tb.holdover          = true;
+        g_tb.holdover_start_us = g_tb.servo.last_edge_us;
+        g_tb.hold_have_temp    = temp_get_mc(&g_tb.hold_temp_mc);
+        g_tb.hold_adj_q32      = 0;
+        g_tb.hold_adj_us       = anchor_us;
+        g_tb.hold_adj_ns       = 0;
+    }
+
+    // Once PPS is back the PLL owns the rate again, even before it relocks.
+    if (g_tb.servo.last_edge_us == g_tb.holdover_start_us) apply_tempco(anchor_us);
+}
+
+// The RP2040 has no 64-bit divider, so the read path uses reciprocal multiplies.
+
+// fraction = nsec * 2^32 / 1e9 = nsec * 4.294967296
+//          ~= (nsec * round(4.294967296 * 2^29)) >> 29   (<= 1 LSB error)
+inline uint32_t nsec_to_ntp_frac(uint32_t nsec) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(nsec) * 2305843009ULL) >> 29);
+}
+
+// Writer side: PPS jitter estimate from a PLL edge's offset.
+void update_jitter(int64_t offset_ns) {
+    const uint64_t a = abs64(offset_ns);
+    if (!g_tb.have_jitter) {
+        g_tb.jitter_ns   = a;
+        g_tb.have_jitter = true;
+        return;
+    }
+    g_tb.jitter_ns = g_tb.jitter_ns - (g_tb.jitter_ns >> JITTER_SHIFT) + (a >> JITTER_SHIFT);
+}
+
+// Writer side, once: time PRECISION_READS back-to-back timestamp reads and
+// round log2 of max(tick, cost per read) to the nearest power of two.
+void measure_precision() {
+    uint32_t s = 0, f = 0;
+    const uint64_t t0 = time_us_64();
+    for (uint32_t i = 0; i < PRECISION_READS; ++i) (void)timebase_now_ntp(&s, &f);
+    const uint64_t cost_ns = (time_us_64() - t0) * 1000ULL / PRECISION_READS;
+    const uint64_t ns = (cost_ns > TIMER_RES_NS) ? cost_ns : TIMER_RES_NS;
+
+    // 2^p s in ns is 1e9 >> -p; step up while even sqrt(2) of it is short.
+    int8_t p = -29;
+    while (p < 0 && ((NSEC_PER_SEC >> -p) * 1414ULL) / 1000ULL < ns) ++p;
+
+    g_tb.precision          = p;
+    g_tb.precision_ns       = NSEC_PER_SEC >> -p;
+    g_tb.precision_measured = true;
+}
+
+// Writer side: what to advertise right now. Also fills the matching
+// status fields (error bound, holdover age).
+void compute_quality(uint64_t now_us, TimebaseQuality* q, TimebaseStatus* st) {
+    uint64_t err_ns = MAX_DISP_NS;
+    const bool pps_live = pps_live_edge_us() != 0 &&
+                          now_us - pps_live_edge_us() <= PPS_STALE_US;
+
+    if (!g_tb.have_time) {
+        q->leap    = 3;
+        q->stratum = 16;
+    } else if (g_tb.synced) {
+        err_ns     = g_tb.lock_error_ns;
+        q->leap    = 0;
+        q->stratum = 1;
+    } else if (g_tb.holdover) {
+        const uint64_t t_s = (now_us - g_tb.holdover_start_us) / 1000000ULL;
+        err_ns = g_tb.lock_error_ns + HOLDOVER_FREQ_ERR_PPB * t_s +
+                 HOLDOVER_DRIFT_PPB_PER_H * t_s * t_s / 7200ULL;
+        st->holdover_s = static_cast<uint32_t>(t_s);
+
+        if (err_ns <= HOLDOVER_STRATUM1_NS) {
+            q->leap    = 0;
+            q->stratum = 1;
+        } else if (err_ns <= HOLDOVER_MAX_NS) {
+            q->leap    = 0;
+            q->stratum = 2;
+        } else {
+            q->leap    = 3;
+            q->stratum = 16;
+        }
+    } else if (g_tb.servo.state != ServoState::Unset && pps_live) {
+        // On PPS but not (yet) locked: FLL, or the PLL pulling in. The last
+        // edge's offset is the best estimate of how far off we are.
+        err_ns     = g_tb.precision_ns + g_tb.jitter_ns + abs64(g_tb.servo.last_offset_ns);
+        q->leap    = 3;
+        q->stratum = 2;
+    } else {
+        // Coarse NMEA time only
+        err_ns     = COARSE_DISP_NS;
+        q->leap    = 3;
+        q->stratum = 2;
+    }
+
+    if (err_ns > MAX_DISP_NS) err_ns = MAX_DISP_NS;
+    q->holdover        = g_tb.holdover;
+    q->precision       = g_tb.precision;
+    q->root_dispersion = ns_to_ntp_short(err_ns);
+    if (g_tb.ref_unix_s) {
+        q->ref_ts_s = static_cast<uint32_t>(g_tb.ref_unix_s + NTP_UNIX_EPOCH_DELTA);
+        q->ref_ts_f = nsec_to_ntp_frac(g_tb.ref_ns);
+    }
+
+    st->holdover  = g_tb.holdover;
+    st->stratum   = q->stratum;
+    st->precision = q->precision;
+    st->error_ns  = (err_ns > UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(err_ns);
+    st->jitter_ns = (g_tb.jitter_ns > UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(g_tb.jitter_ns);
+}
+
+// Writer side: temperature model state for readers.
+void fill_tempco(TimebaseTempco* out) {
+    *out = g_tb.tc_recovery;
+
+    const Tempco& tc = g_tb.tempco;
+    out->order     = tc.order;
+    out->bins      = tc.bins_used;
+    out->samples   = tc.samples;
+    out->resid_ppb = static_cast<int32_t>(tempco_resid_rms_ppb(&tc) + 0.5f);
+
+    int32_t t_mc = 0;
+    float ppb = 0.0f;
+    out->have_temp = temp_get_mc(&t_mc);
+    out->temp_mc   = t_mc;
+    if (out->have_temp && tempco_predict(&tc, t_mc, &ppb)) {
+        out->pred_ppb = static_cast<int32_t>(ppb < 0.0f ? ppb - 0.5f : ppb + 0.5f);
+    }
+
+    if (g_tb.holdover) {
+        out->hold_adj_ppb = static_cast<int32_t>((g_tb.hold_adj_q32 * 1000000000LL) / 4294967296LL);
+        out->hold_adj_ns  = g_tb.hold_adj_ns;
+    }
+}
+
+// Writer side: rebuild the reader views from the servo.
+void publish_from_servo(bool have_time, bool synced) {
+    g_tb.have_time = have_time;
+    g_tb.synced    = synced;
+    g_tb.last_publish_us = time_us_64();
+
+    Snapshot snap{};
+    snap.model          = g_tb.servo.model;
+    snap.ref_ntp_s      = static_cast<uint32_t>(snap.model.ref_unix_s + NTP_UNIX_EPOCH_DELTA);
+    snap.have_time      = have_time;
+    snap.synced         = synced;
+    snap.pps_edge_us    = pps_live_edge_us();
+    g_tb.view.publish(snap);
+
+    TimebaseStatus st{};
+    st.have_time      = have_time;
+    st.synced         = synced;
+    st.servo_state    = g_tb.servo.state;
+    st.last_offset_ns = g_tb.servo.last_offset_ns;
+    st.freq_ppb       = servo_freq_ppb(&g_tb.servo);
+    st.steps          = g_tb.servo.steps;
+    st.updates        = g_tb.servo.updates;
+
+    TimebaseQuality q{};
+    compute_quality(g_tb.last_publish_us, &q, &st);
+    fill_tempco(&st.tempco);
+    g_tb.quality_view.publish(q);
+    g_tb.status_view.publish(st);
+}
+
+// Evaluate the published model at local_us as (whole seconds past the
+// reference, nsec). Only multiplies plus a short carry loop.
+void eval_fast(const Snapshot& snap, uint64_t local_us, uint32_t* carry_s, uint32_t* nsec) {
+    uint64_t ns = snap.model.ref_ns + servo_model_elapsed_ns(&snap.model, local_us);
+
+    if (ns >= FAST_EVAL_MAX_NS) {
+        // Writer stalled: take the dividing path once.
+        *carry_s = static_cast<uint32_t>(ns / NSEC_PER_SEC);
+        *nsec    = static_cast<uint32_t>(ns % NSEC_PER_SEC);
+        return;
+    }
+
+    uint32_t carry = 0;
+    while (ns >= NSEC_PER_SEC) {
+        ns -= NSEC_PER_SEC;
+        ++carry;
+    }
+    *carry_s = carry;
+    *nsec    = static_cast<uint32_t>(ns);
 }
 
-inline void unlock_tb(uint32_t save) {
-    spin_unlock(g_tb.lock, save);
+// Writer side: one labeled PPS edge into the servo.
+void feed_edge(const PpsEdge& e, uint64_t unix_s) {
+    const uint64_t edge_us = e.edge_us();
+    const uint32_t frac_ns = static_cast<uint32_t>(e.edge_ns % 1000u);   // 0 unless PPS_PIO
+
+    // Still running on the holdover model: this edge measures it.
+    const bool first_after_holdover = g_tb.holdover &&
+                                      g_tb.servo.state == ServoState::Pll &&
+                                      g_tb.servo.last_edge_us == g_tb.holdover_start_us;
+    if (servo_on_edge(&g_tb.servo, edge_us, frac_ns, unix_s)) {
+        if (g_tb.servo.state == ServoState::Pll) update_jitter(g_tb.servo.last_offset_ns);
+        // Pull-in transients would swamp the statistics for hours.
+        if (servo_is_locked(&g_tb.servo)) stability_add(unix_s, g_tb.servo.last_offset_ns);
+        g_tb.ref_unix_s = unix_s;
+        g_tb.ref_ns     = 0;
+    }
+    if (first_after_holdover) record_recovery(edge_us);
 }
 
-inline uint64_t snap_us_to_second(uint64_t t_us) {
-    return t_us - (t_us % USEC_PER_SEC);
+// Extra pulses and interval outliers (pps_stats) never get a label.
+inline bool edge_rejected(uint32_t seq) {
+    const PpsVerdict v = pps_stats_verdict(seq);
+    return v == PpsVerdict::Outlier || v == PpsVerdict::Extra;
 }
 
-inline uint32_t usec_to_ntp_frac(uint32_t usec) {
-    // fraction = usec * 2^32 / 1e6, with 64-bit intermediate
-    return static_cast<uint32_t>((static_cast<uint64_t>(usec) << 32) / USEC_PER_SEC);
+// Whole seconds from edge e to a later edge at to_ns, or 0 if the spacing
+// isn't close enough to a whole number of seconds to label it.
+uint32_t seconds_back(const PpsEdge& e, uint64_t to_ns) {
+    if (e.edge_ns >= to_ns) return 0;
+    const uint64_t dt = to_ns - e.edge_ns;
+    const uint64_t n  = (dt + NSEC_PER_SEC / 2) / NSEC_PER_SEC;
+    if (n == 0 || n > PPS_BACKFILL_MAX_S) return 0;
+
+    const uint64_t whole = n * NSEC_PER_SEC;
+    const uint64_t err = (dt > whole) ? (dt - whole) : (whole - dt);
+    return (err <= n * PPS_LABEL_TOL_NS_PER_S) ? static_cast<uint32_t>(n) : 0;
+}
+
+// First PPS edge in the label window: edges from here on may still be
+// labeled by the next RMC (directly or by backfill), so the model must not
+// be re-anchored past it. Oldest-first, limited to the backfill range.
+uint32_t first_label_seq(uint32_t head) {
+    uint32_t seq = g_tb.pps_seq + 1u;
+    if (head > PPS_BACKFILL_MAX_S && seq < head - PPS_BACKFILL_MAX_S) seq = head - PPS_BACKFILL_MAX_S;
+    return seq;
+}
+
+// Captured edges the servo has not seen yet. The oldest one the next RMC
+// could still label bounds re-anchoring; the newest one that could still be
+// backfilled (if any) keeps PPS counted as live through missed sentences.
+void scan_unlabeled(uint64_t now_us, uint64_t* oldest_us, uint64_t* pending_us) {
+    constexpr uint64_t WINDOW_US = PPS_BACKFILL_MAX_S * 1000000ULL + RMC_PPS_MAX_LAG_US;
+    constexpr uint64_t REACH_US  = PPS_BACKFILL_MAX_S * 1000000ULL + PPS_BACKFILL_MAX_S * PPS_LABEL_TOL_NS_PER_S / 1000u;
+
+    const uint64_t last_us = g_tb.servo.last_edge_us;
+    *oldest_us  = 0;
+    *pending_us = 0;
+
+    const uint32_t head = pps_get_edges();
+    for (uint32_t seq = first_label_seq(head); seq != 0 && seq <= head; ++seq) {
+        PpsEdge e;
+        if (!pps_get_edge(seq, &e) || edge_rejected(seq)) continue;
+        const uint64_t us = e.edge_us();
+        if (us <= last_us) continue;
+
+        if (*oldest_us == 0 && (seq == head || now_us - us <= WINDOW_US)) *oldest_us = us;
+        if (last_us != 0 && us - last_us <= REACH_US) *pending_us = us;
+    }
 }
 
 } // namespace
@@ -61,99 +502,201 @@ inline uint32_t usec_to_ntp_frac(uint32_t usec) {
 void timebase_init(void) {
     if (g_tb.inited) return;
 
-    g_tb.lock_num = spin_lock_claim_unused(true);
-    g_tb.lock = spin_lock_init(g_tb.lock_num);
-
-    const uint32_t save = lock_tb();
-    g_tb.base_unix = 0;
-    g_tb.base_us   = 0;
-    g_tb.have_time = false;
-    g_tb.synced    = false;
-    unlock_tb(save);
-
+    servo_init(&g_tb.servo);
+    stability_reset();
     g_tb.inited = true;
+    publish_from_servo(false, false);
 }
 
 void timebase_clear(void) {
-    if (!g_tb.inited || !g_tb.lock) return;
+    if (!g_tb.inited) return;
+
+    servo_init(&g_tb.servo);
+    g_tb.pending_edge_us = 0;
+    g_tb.have_lock   = false;
+    g_tb.holdover    = false;
+    g_tb.have_jitter = false;
+    g_tb.jitter_ns   = 0;
+    g_tb.ref_unix_s  = 0;
+    stability_reset();
+    publish_from_servo(false, false);
+}
 
-    const uint32_t save = lock_tb();
-    g_tb.have_time = false;
-    g_tb.synced    = false;
-    g_tb.base_unix = 0;
-    g_tb.base_us   = 0;
-    unlock_tb(save);
+void timebase_service(void) {
+    if (!g_tb.inited || !g_tb.have_time) return;
+
+    const uint64_t now_us = time_us_64();
+    if (now_us - g_tb.last_publish_us < REFRESH_US) return;
+
+    // Nothing new from GPS this second; move the reference up so readers
+    // keep a fresh per-second epoch and short deltas. Stop at the oldest PPS
+    // edge the next RMC may still label: the servo measures that edge
+    // against the model, which clamps anything before its reference.
+    uint64_t anchor_us = now_us;
+    uint64_t edge_us = 0;
+    scan_unlabeled(now_us, &edge_us, &g_tb.pending_edge_us);
+    if (edge_us != 0 && edge_us < anchor_us) anchor_us = edge_us;
+    servo_reanchor(&g_tb.servo, anchor_us);
+
+    // Lock is only as good as the PPS behind it.
+    const bool synced = g_tb.synced && (now_us - pps_live_edge_us() <= PPS_STALE_US);
+    update_holdover(synced, anchor_us);
+    publish_from_servo(g_tb.have_time, synced);
 }
 
 bool timebase_have_time(void) {
-    if (!g_tb.inited || !g_tb.lock) return false;
-
-    const uint32_t save = lock_tb();
-    const bool v = g_tb.have_time;
-    unlock_tb(save);
-    return v;
+    Snapshot snap;
+    return read_snapshot(&snap) && snap.have_time;
 }
 
 bool timebase_is_synced(void) {
-    if (!g_tb.inited || !g_tb.lock) return false;
+    Snapshot snap;
+    if (!read_snapshot(&snap) || !snap.synced) return false;
 
-    const uint32_t save = lock_tb();
-    const bool v = g_tb.synced;
-    unlock_tb(save);
-    return v;
+    const uint64_t last_edge_us = snap.pps_edge_us;
+    return (last_edge_us != 0) && (time_us_64() - last_edge_us <= PPS_STALE_US);
 }
 
 void timebase_on_gps_utc_unix(uint64_t unix_utc_seconds) {
-    if (!g_tb.inited || !g_tb.lock) return;
+    if (!g_tb.inited) return;
 
     // Local monotonic time in us since boot
-    const uint64_t now_us = time_us_64();
-
-    // SNAP to the *start* of the current second to remove NMEA arrival latency bias
-    const uint64_t snapped_us = snap_us_to_second(now_us);
-
-    const uint32_t save = lock_tb();
-    g_tb.base_unix = unix_utc_seconds;
-    g_tb.base_us   = snapped_us;
-    g_tb.have_time = true;
-    g_tb.synced    = true;   // later: require GPS Locked + PPS discipline
-    unlock_tb(save);
+    const uint64_t now_us  = time_us_64();
+    // Newest edge that can start a second; one the filter threw out may
+    // have arrived after the real one.
+    PpsEdge latest;
+    bool have_edge = pps_get_latest(&latest);
+    while (have_edge && edge_rejected(latest.seq)) have_edge = pps_get_edge(latest.seq - 1u, &latest);
+    const uint64_t edge_us = have_edge ? latest.edge_us() : 0;
+
+    // The edge that started this second, if PPS is running
+    const bool pps_fresh = (edge_us != 0) && (now_us >= edge_us) &&
+                           (now_us - edge_us < RMC_PPS_MAX_LAG_US);
+    const bool pps_live  = pps_live_edge_us() != 0 &&
+                           now_us - pps_live_edge_us() <= PPS_STALE_US;
+
+    if (pps_fresh) {
+        if (latest.seq != g_tb.pps_seq) {
+            // Edges whose RMC went missing since the last label go first,
+            // counted back in whole seconds from this one.
+            for (uint32_t seq = first_label_seq(latest.seq); seq < latest.seq; ++seq) {
+                PpsEdge e;
+                if (!pps_get_edge(seq, &e) || edge_rejected(seq)) continue;
+                if (e.edge_us() <= g_tb.servo.last_edge_us) continue;
+                const uint32_t back = seconds_back(e, latest.edge_ns);
+                if (back != 0) feed_edge(e, unix_utc_seconds - back);
+            }
+            feed_edge(latest, unix_utc_seconds);
+            g_tb.pps_seq = latest.seq;
+        }
+    } else if (pps_live && g_tb.servo.state == ServoState::Pll) {
+        // This second's pulse is missing but PPS is still live: nothing to
+        // measure, and the sentence's arrival time is far worse than the model.
+    } else {
+        // No PPS: fall back to sentence arrival time (late by the NMEA latency).
+        const uint32_t steps = g_tb.servo.steps;
+        servo_coarse(&g_tb.servo, now_us, unix_utc_seconds);
+        if (g_tb.servo.steps != steps) {
+            g_tb.ref_unix_s = unix_utc_seconds;
+            g_tb.ref_ns     = 0;
+        }
+    }
+
+    const bool synced = (pps_fresh || pps_live) && servo_is_locked(&g_tb.servo);
+    if (synced && pps_fresh) learn_tempco(edge_us);
+    update_holdover(synced, now_us);
+    publish_from_servo(true, synced);
+
+    if (!g_tb.precision_measured) {
+        // Needs a published model so the reads take the full path
+        measure_precision();
+        publish_from_servo(true, synced);
+    }
 }
 
 bool timebase_now_unix(uint64_t* unix_seconds, uint32_t* usec) {
     if (!unix_seconds || !usec) return false;
-    if (!g_tb.inited || !g_tb.lock) return false;
 
-    uint64_t base_unix = 0;
-    uint64_t base_us   = 0;
-    bool have = false;
+    uint64_t s = 0;
+    uint32_t ns = 0;
+    if (!timebase_local_to_unix(time_us_64(), &s, &ns)) return false;
 
-    const uint32_t save = lock_tb();
-    base_unix = g_tb.base_unix;
-    base_us   = g_tb.base_us;
-    have      = g_tb.have_time;
-    unlock_tb(save);
+    *unix_seconds = s;
+    *usec = nsec_to_usec(ns);
+    return true;
+}
 
-    if (!have) return false;
+bool timebase_local_to_unix(uint64_t local_us, uint64_t* unix_seconds, uint32_t* nsec) {
+    if (!unix_seconds || !nsec) return false;
 
-    const uint64_t now_us = time_us_64();
-    const uint64_t delta_us = (now_us >= base_us) ? (now_us - base_us) : 0;
+    Snapshot snap;
+    if (!read_snapshot(&snap) || !snap.have_time) return false;
 
-    *unix_seconds = base_unix + (delta_us / USEC_PER_SEC);
-    *usec = static_cast<uint32_t>(delta_us % USEC_PER_SEC);
+    uint32_t carry = 0;
+    eval_fast(snap, local_us, &carry, nsec);
+    *unix_seconds = snap.model.ref_unix_s + carry;
+    return true;
+}
+
+bool timebase_unix_to_local(uint64_t unix_seconds, uint32_t nsec, uint64_t* local_us, uint32_t* frac_ns) {
+    if (!local_us || !frac_ns || nsec >= NSEC_PER_SEC) return false;
+
+    Snapshot snap;
+    if (!read_snapshot(&snap) || !snap.have_time) return false;
+
+    const ServoModel& m = snap.model;
+    if (unix_seconds < m.ref_unix_s || unix_seconds - m.ref_unix_s > UNIX_TO_LOCAL_MAX_S) return false;
+    const int64_t t_ns = static_cast<int64_t>((unix_seconds - m.ref_unix_s) * NSEC_PER_SEC + nsec) - m.ref_ns;
+    if (t_ns < 0) return false;
+
+    // Local ns dt with dt * (1 + rate) = t_ns, by fixed-point iteration; the
+    // residual is t * rate^4, nothing at the servo's 1000 ppm limit.
+    int64_t dt = t_ns;
+    for (int i = 0; i < 3; ++i) dt = t_ns - ((dt * m.rate_q32) >> 32);
+
+    const uint64_t local_ns = m.ref_local_us * 1000ULL + static_cast<uint64_t>(dt);
+    *local_us = local_ns / 1000u;
+    *frac_ns  = static_cast<uint32_t>(local_ns % 1000u);
     return true;
 }
 
 bool timebase_now_ntp(uint32_t* ntp_seconds, uint32_t* ntp_fraction) {
     if (!ntp_seconds || !ntp_fraction) return false;
 
-    uint64_t unix_s = 0;
-    uint32_t usec = 0;
-    if (!timebase_now_unix(&unix_s, &usec)) return false;
+    return timebase_local_to_ntp(time_us_64(), ntp_seconds, ntp_fraction);
+}
+
+bool timebase_local_to_ntp(uint64_t local_us, uint32_t* ntp_seconds, uint32_t* ntp_fraction) {
+    if (!ntp_seconds || !ntp_fraction) return false;
+
+    Snapshot snap;
+    if (!read_snapshot(&snap) || !snap.have_time) return false;
+
+    // NTP seconds at the reference are cached by the writer; the 32-bit
+    // add wraps into the next NTP era exactly like the 64-bit sum would.
+    uint32_t carry = 0;
+    uint32_t nsec  = 0;
+    eval_fast(snap, local_us, &carry, &nsec);
+    *ntp_seconds  = snap.ref_ntp_s + carry;
+    *ntp_fraction = nsec_to_ntp_frac(nsec);
+    return true;
+}
+
+bool timebase_get_quality(TimebaseQuality* out) {
+    if (!out) return false;
 
-    const uint64_t ntp_s_64 = unix_s + NTP_UNIX_EPOCH_DELTA;
-    *ntp_seconds  = static_cast<uint32_t>(ntp_s_64);
-    *ntp_fraction = usec_to_ntp_frac(usec);
+    if (!g_tb.inited || !g_tb.quality_view.read(out, READ_MAX_TRIES, &g_tb.read_retries)) {
+        *out = TimebaseQuality{};
+        return false;
+    }
     return true;
 }
 
+void timebase_get_status(TimebaseStatus* out) {
+    if (!out) return;
+
+    if (!g_tb.inited || !g_tb.status_view.read(out, READ_MAX_TRIES, &g_tb.read_retries)) {
+        *out = TimebaseStatus{};
+    }
+    out->read_retries = g_tb.read_retries;
+}
@@ -13,25 +13,116 @@
 #pragma once
 #include <cstdint>
 
+#include "servo.h"
+
+// Concurrency: one writer (the RMC/PPS path) publishes a complete snapshot
+// through a double-buffered seqlock. All readers are lock-free and IRQ-safe,
+// and may run on either core.
+
 // Call once at boot
 void timebase_init(void);
 
-// Feed UTC Unix seconds when you have valid RMC/ZDA time+date
+// Feed UTC Unix seconds when you have valid RMC/ZDA time+date.
+// The second is paired with the newest PPS edge the filter accepted
+// (pps_get_latest(), stepping back past rejected edges) and fed to the clock
+// servo, after any earlier edges in the ring that missed their sentence,
+// counted back in whole seconds. Without PPS it falls back to sentence
+// arrival time.
 void timebase_on_gps_utc_unix(uint64_t unix_utc_seconds);
 
+// Call from the writer's loop. Re-anchors and republishes once per second
+// when no GPS update did, keeping the read path division-free.
+void timebase_service(void);
+
 // Optional: if you want to explicitly clear time validity
 void timebase_clear(void);
 
 // True when we have a valid UTC time baseline (not necessarily PPS-disciplined)
 bool timebase_have_time(void);
 
-// Your existing concept: "synced" (you can refine later to mean GPS Locked+PPS)
+// True when the servo is phase-locked to a live PPS.
 bool timebase_is_synced(void);
 
 // Get "now" as NTP timestamp (seconds since 1900 + 32-bit fraction).
 // Returns false if time is not available.
 bool timebase_now_ntp(uint32_t* ntp_seconds, uint32_t* ntp_fraction);
 
+// Same, for a captured local time_us_64() value.
+bool timebase_local_to_ntp(uint64_t local_us, uint32_t* ntp_seconds, uint32_t* ntp_fraction);
+
 // Get Unix seconds+usec for debugging/UI (optional)
 bool timebase_now_unix(uint64_t* unix_seconds, uint32_t* usec);
 
+// Convert a captured local time_us_64() value to Unix seconds+nsec.
+bool timebase_local_to_unix(uint64_t local_us, uint64_t* unix_seconds, uint32_t* nsec);
+
+// The inverse: the local time_us_64() value (plus frac_ns below the
+// microsecond) at which the timebase will read unix_seconds + nsec, on the
+// current model. For scheduling output edges; the target must lie within a
+// few seconds of now. Returns false without time, or when it doesn't.
+bool timebase_unix_to_local(uint64_t unix_seconds, uint32_t nsec, uint64_t* local_us, uint32_t* frac_ns);
+
+// What a reply should advertise (RFC 5905 header fields), recomputed by the
+// writer at least once per second and cached for the packet path. Holdover
+// keeps stratum 1 while the estimated error stays small, then demotes;
+// root_dispersion carries the estimate (timestamp precision + PPS jitter
+// when locked, the last PPS offset while pulling in, the holdover bound)
+// in NTP short format (16.16 seconds).
+struct TimebaseQuality {
+    uint8_t  leap            = 3;    // LI: 0 = no warning, 3 = unsynchronized
+    uint8_t  stratum         = 16;
+    int8_t   precision       = -20;  // log2 s; measured once time is available
+    uint32_t root_dispersion = 0;
+    uint32_t ref_ts_s        = 0;    // NTP time of the last discipline update
+    uint32_t ref_ts_f        = 0;    // (0 = never)
+    bool     holdover        = false;
+};
+
+// One consistent read of the above, host order. Returns false (and
+// "unsynchronized") before timebase_init().
+bool timebase_get_quality(TimebaseQuality* out);
+
+// Temperature model (tempco.h): how well the learned frequency-vs-temperature
+// curve tracks the servo while locked, and what it did in holdover.
+struct TimebaseTempco {
+    uint8_t  order         = 0;   // 0 = no fit yet, 1 = linear, 2 = quadratic
+    uint8_t  bins          = 0;   // 1 C bins with enough samples
+    uint32_t samples       = 0;
+    bool     have_temp     = false;
+    int32_t  temp_mc       = 0;   // smoothed die temperature
+    int32_t  pred_ppb      = 0;   // curve at temp_mc
+    int32_t  resid_ppb     = 0;   // rms of (curve - servo) at locked samples
+
+    // Holdover: correction applied now, and its phase integrated so far
+    int32_t  hold_adj_ppb  = 0;
+    int64_t  hold_adj_ns   = 0;
+
+    // First PPS edge after the last holdover: the phase error measured
+    // (actual) and what it would have been without the correction.
+    bool     have_recovery       = false;
+    uint32_t recovery_after_s    = 0;
+    int64_t  recovery_err_ns     = 0;
+    int64_t  recovery_uncomp_ns  = 0;
+};
+
+struct TimebaseStatus {
+    bool       have_time      = false;
+    bool       synced         = false;
+    ServoState servo_state    = ServoState::Unset;
+    int64_t    last_offset_ns = 0;   // phase error at the last PPS edge
+    int32_t    freq_ppb       = 0;   // learned oscillator correction
+    uint32_t   steps          = 0;
+    uint32_t   updates        = 0;
+    uint32_t   read_retries   = 0;   // torn seqlock reads (should stay ~0)
+    bool       holdover       = false;
+    uint32_t   holdover_s     = 0;   // since the last locked PPS edge
+    uint32_t   error_ns       = 0;   // estimated error bound (root dispersion)
+    uint32_t   jitter_ns      = 0;   // mean |PPS offset| while in PLL
+    uint8_t    stratum        = 16;
+    int8_t     precision      = -20;
+    TimebaseTempco tempco{};
+};
+
+// Snapshot of the discipline state for UI/diagnostics.
+void timebase_get_status(TimebaseStatus* out);
+
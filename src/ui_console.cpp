@@ -24,6 +24,12 @@
 
 #include "hardware/timer.h"
 #include "pps.h"
+#include "pps_out.h"
+#include "pps_stats.h"
+#include "stability.h"
+#include "timebase.h"
+#include "core_load.h"
+#include "gps_uart.h"
 
 namespace {
 
@@ -39,15 +45,61 @@ static constexpr const char* ANSI_HIDE_CURSOR = "\x1b[?25l";
 
 static bool g_once = false;
 
+// Per-second rate of a cumulative counter between dashboard refreshes
+struct RateMeter {
+    uint32_t prev    = 0;
+    uint64_t prev_us = 0;
+};
+
+static uint32_t rate_update(RateMeter* m, uint32_t count)
+{
+    const uint64_t now_us = time_us_64();
+    uint32_t rate = 0;
+    if (m->prev_us != 0 && now_us > m->prev_us) {
+        rate = static_cast<uint32_t>((static_cast<uint64_t>(count - m->prev) * 1000000ULL) /
+                                     (now_us - m->prev_us));
+    }
+    m->prev    = count;
+    m->prev_us = now_us;
+    return rate;
+}
+
+static RateMeter g_ntp_tx_rate;
+static RateMeter g_uart_byte_rate;
+static RateMeter g_uart_irq_rate;
+static RateMeter g_uart_irq_us_rate;
+
+static void draw_uart_line()
+{
+    GpsUartStats st{};
+    GpsUart::get_stats(&st);
+
+    std::printf("GPS UART     : %s, %lu B/s, %lu irq/s, %lu us/s in IRQ\r\n",
+                st.dma ? "DMA" : "IRQ",
+                (unsigned long)rate_update(&g_uart_byte_rate, st.bytes),
+                (unsigned long)rate_update(&g_uart_irq_rate, st.irqs),
+                (unsigned long)rate_update(&g_uart_irq_us_rate, st.irq_us));
+    std::printf("GPS Lines    : %lu (truncated %lu, overflow %lu bytes)\r\n",
+                (unsigned long)st.lines, (unsigned long)st.truncated,
+                (unsigned long)st.overflow);
+}
+
 static void draw_pps_block()
 {
-    const uint32_t edges = pps_get_edges();
-    const uint32_t dt_us = pps_get_last_interval_us();
-    const uint64_t last_edge_us = pps_get_last_edge_us();
+    PpsEdge e;
+    pps_get_latest(&e);
+    const uint32_t edges = e.seq;
+    const uint32_t dt_us = e.interval_us;
+    const uint64_t last_edge_us = e.edge_us();
     const uint64_t now_us = time_us_64();
 
     std::printf("\r\n");
     std::printf("PPS (GPIO16) : %s\r\n", edges ? "DETECTED" : "NO EDGES");
+    if (pps_capture_is_pio()) {
+        std::printf("PPS Capture  : PIO (resyncs %lu)\r\n", (unsigned long)pps_get_capture_resyncs());
+    } else {
+        std::printf("PPS Capture  : IRQ\r\n");
+    }
     // std::printf("PPS Edges    : %lu\r\n", (unsigned long)edges);
 
     if (dt_us > 0) {
@@ -71,6 +123,86 @@ static void draw_pps_block()
                     (unsigned long)age_s,
                     (unsigned long)rem_ms);
     }
+
+    // Interval statistics, ns from 1 s (+ = local timer fast)
+    PpsStats ps{};
+    pps_stats_get(&ps);
+    if (ps.long_win.n == 0) {
+        std::printf("PPS Stats    : (learning)\r\n");
+    } else {
+        const PpsWindowStats& sw = ps.short_win;
+        const PpsWindowStats& lw = ps.long_win;
+        std::printf("PPS Stats    : %lus mean %+ld std %lu ns, %lus mean %+ld std %lu [%+ld, %+ld] ns\r\n",
+                    (unsigned long)sw.n, (long)sw.mean_ns, (unsigned long)sw.std_ns,
+                    (unsigned long)lw.n, (long)lw.mean_ns, (unsigned long)lw.std_ns,
+                    (long)lw.min_ns, (long)lw.max_ns);
+    }
+    std::printf("PPS Filter   : %smedian %+ld MAD %lu tol %lu ns%s, %lu outlier, %lu extra, %lu missing, %lu lost\r\n",
+                ps.filter_ready ? ANSI_GRN : ANSI_YEL,
+                (long)ps.median_ns, (unsigned long)ps.mad_ns, (unsigned long)ps.tol_ns, ANSI_CLR,
+                (unsigned long)ps.outliers, (unsigned long)ps.extra,
+                (unsigned long)ps.missing, (unsigned long)ps.lost);
+
+    // Our own disciplined output, against the GPS edges (+ = output late)
+    PpsOutStats po{};
+    pps_out_get(&po);
+    if (!po.running) {
+        std::printf("PPS Out      : OFF\r\n");
+    } else {
+        std::printf("PPS Out      : GPIO%lu", (unsigned long)PPS_OUT_GPIO);
+        if (po.freq_hz) std::printf(" + %lu Hz on GPIO%lu", (unsigned long)po.freq_hz, (unsigned long)PPS_OUT_FREQ_GPIO);
+        std::printf(", %lu pulses (%lu late, %lu skipped)\r\n",
+                    (unsigned long)po.pulses, (unsigned long)po.late, (unsigned long)po.skipped);
+        std::printf("PPS Out Err  : last %+ld ns, %lus mean %+ld rms %lu max %lu ns, %lu unmatched\r\n",
+                    (long)po.last_err_ns, (unsigned long)po.win_n, (long)po.mean_ns,
+                    (unsigned long)po.rms_ns, (unsigned long)po.max_abs_ns, (unsigned long)po.unmatched);
+    }
+}
+
+static void draw_timebase_block()
+{
+    TimebaseStatus tb{};
+    timebase_get_status(&tb);
+
+    // Offsets beyond +/-2 s don't fit a 32-bit long; they only happen before the first step.
+    int64_t off = tb.last_offset_ns;
+    if (off >  2000000000LL) off =  2000000000LL;
+    if (off < -2000000000LL) off = -2000000000LL;
+
+    std::printf("Servo        : %s%s%s\r\n",
+                tb.synced ? ANSI_GRN : ANSI_YEL,
+                tb.have_time ? servo_state_str(tb.servo_state) : "NO TIME",
+                ANSI_CLR);
+    std::printf("PPS Offset   : %ld ns\r\n", (long)off);
+    std::printf("Osc Freq     : %ld ppb\r\n", (long)tb.freq_ppb);
+    std::printf("Serving      : stratum %u, est. error %lu ns, precision 2^%d s\r\n",
+                (unsigned)tb.stratum, (unsigned long)tb.error_ns, (int)tb.precision);
+    std::printf("PPS Jitter   : %lu ns\r\n", (unsigned long)tb.jitter_ns);
+    if (tb.holdover) {
+        std::printf("Holdover     : %s%lu s%s, tempco adj %ld ppb (%ld ns so far)\r\n",
+                    ANSI_YEL, (unsigned long)tb.holdover_s, ANSI_CLR,
+                    (long)tb.tempco.hold_adj_ppb, (long)tb.tempco.hold_adj_ns);
+    }
+
+    const TimebaseTempco& tc = tb.tempco;
+    if (tc.order == 0) {
+        std::printf("Tempco       : learning (%lu samples, %u bins)\r\n",
+                    (unsigned long)tc.samples, (unsigned)tc.bins);
+    } else {
+        std::printf("Tempco       : %s fit over %u bins, predicts %ld ppb (servo %ld), resid %ld ppb rms\r\n",
+                    tc.order == 2 ? "quadratic" : "linear", (unsigned)tc.bins,
+                    (long)tc.pred_ppb, (long)tb.freq_ppb, (long)tc.resid_ppb);
+    }
+    if (tc.have_recovery) {
+        // Clamp like the PPS offset above
+        int64_t err = tc.recovery_err_ns, unc = tc.recovery_uncomp_ns;
+        if (err >  2000000000LL) err =  2000000000LL;
+        if (err < -2000000000LL) err = -2000000000LL;
+        if (unc >  2000000000LL) unc =  2000000000LL;
+        if (unc < -2000000000LL) unc = -2000000000LL;
+        std::printf("Last Holdover: %lu s, error %ld ns (without tempco %ld ns)\r\n",
+                    (unsigned long)tc.recovery_after_s, (long)err, (long)unc);
+    }
 }
 
 static inline const char* gps_state_color(GPSDeviceState s)
@@ -114,6 +246,81 @@ static void print_fixed_1(const char* label, int32_t deci, const char* unit)
     std::printf("%-12s: %ld.%01ld %s\r\n", label, (long)whole, (long)frac, unit);
 }
 
+// HH:MM:SS.mmmZ from milliseconds of day
+static void print_time_of_day(int32_t ms)
+{
+    const int32_t s = ms / 1000;
+    std::printf("%02ld:%02ld:%02ld.%03ldZ\r\n",
+                (long)(s / 3600), (long)((s / 60) % 60), (long)(s % 60), (long)(ms % 1000));
+}
+
+// Signed micro-degrees -> "48.117300 N, 11.516667 E"
+static void print_udeg(const char* label, int32_t lat, char n, char s,
+                       int32_t lon, char e, char w)
+{
+    const uint32_t alat = (uint32_t)(lat < 0 ? -(int64_t)lat : lat);
+    const uint32_t alon = (uint32_t)(lon < 0 ? -(int64_t)lon : lon);
+    std::printf("%-12s: %lu.%06lu %c, %lu.%06lu %c\r\n", label,
+                (unsigned long)(alat / 1000000u), (unsigned long)(alat % 1000000u), lat < 0 ? s : n,
+                (unsigned long)(alon / 1000000u), (unsigned long)(alon % 1000000u), lon < 0 ? w : e);
+}
+
+// Positive value as "3.1e-07" without float printf ("-" for none)
+static void fmt_sci(char* buf, size_t len, float v)
+{
+    if (!(v > 0.0f)) {
+        std::snprintf(buf, len, "-");
+        return;
+    }
+    int exp = 0;
+    while (v >= 10.0f) { v /= 10.0f; ++exp; }
+    while (v < 1.0f)   { v *= 10.0f; --exp; }
+    int32_t d = (int32_t)(v * 10.0f + 0.5f);   // 2 significant digits
+    if (d >= 100) { d = 10; ++exp; }
+    std::snprintf(buf, len, "%ld.%lde%c%02d", (long)(d / 10), (long)(d % 10),
+                  exp < 0 ? '-' : '+', exp < 0 ? -exp : exp);
+}
+
+static void draw_stability_block()
+{
+    StabilityReport r{};
+    stability_get(&r);
+
+    std::printf("Stability    : %lu samples, %lu s contiguous, %lu gaps ('a' dumps CSV)\r\n",
+                (unsigned long)r.samples, (unsigned long)r.run_s, (unsigned long)r.gaps);
+    if (r.pt[0].n_adev == 0) return;
+
+    char buf[16];
+    std::printf("  tau s      :");
+    for (const StabilityPoint& p : r.pt) {
+        if (p.n_adev) std::printf(" %8lu", (unsigned long)p.tau_s);
+    }
+    std::printf("\r\n  ADEV       :");
+    for (const StabilityPoint& p : r.pt) {
+        if (!p.n_adev) continue;
+        fmt_sci(buf, sizeof buf, p.adev);
+        std::printf(" %8s", buf);
+    }
+    std::printf("\r\n  MDEV       :");
+    for (const StabilityPoint& p : r.pt) {
+        if (!p.n_adev) continue;
+        fmt_sci(buf, sizeof buf, p.n_mdev ? p.mdev : 0.0f);
+        std::printf(" %8s", buf);
+    }
+    std::printf("\r\n  TDEV ns    :");
+    for (const StabilityPoint& p : r.pt) {
+        if (!p.n_adev) continue;
+        if (!p.n_mdev) {
+            std::printf(" %8s", "-");
+            continue;
+        }
+        const int32_t deci = to_fixed(p.tdev_ns, 10);
+        std::snprintf(buf, sizeof buf, "%ld.%01ld", (long)(deci / 10), (long)(deci % 10));
+        std::printf(" %8s", buf);
+    }
+    std::printf("\r\n");
+}
+
 static void draw_header()
 {
     std::printf("NTPServer (Pico W)  |  GPS/NTP Status\r\n");
@@ -122,39 +329,78 @@ static void draw_header()
 
 static void draw_gps_block()
 {
-    const char* st = state_str(g_state);
-    const char* col = gps_state_color(g_state);
+    const GPSDeviceState state = g_state;
+    const char* st = state_str(state);
+    const char* col = gps_state_color(state);
+
+    GpsStatus status{};
+    gps_state_get_status(&status);
 
     std::printf("GPS State    : %s%s%s\r\n", col, st, ANSI_CLR);
-    std::printf("RMC Valid    : %s\r\n", yesno(gps.rmc_valid));
-    std::printf("GGA Fix      : %s\r\n", yesno(gps.gga_fix));
-    std::printf("Satellites   : %d\r\n", gps.sats);
+    std::printf("RMC Valid    : %s\r\n", yesno(status.rmc_valid));
+    std::printf("GGA Fix      : %s\r\n", yesno(status.gga_fix));
+    std::printf("Satellites   : %d\r\n", status.sats);
 
-    if (gps.hdop >= 0.0f) {
-        const int32_t hdop_deci = to_fixed(gps.hdop, 10);
-        print_fixed_1("HDOP", hdop_deci, "");
+    if (status.hdop_centi >= 0) {
+        print_fixed_2("HDOP", status.hdop_centi, "");
     } else {
         std::printf("%-12s: (waiting)\r\n", "HDOP");
     }
 
-    std::printf("UTC (ZDA)    : %s\r\n", gps.last_zda[0] ? gps.last_zda : "(waiting)");
-    std::printf("UTC (RMC)    : %s\r\n", gps.last_rmc_time[0] ? gps.last_rmc_time : "(waiting)");
+    if (status.have_position) {
+        print_udeg("Position", status.lat_udeg, 'N', 'S', status.lon_udeg, 'E', 'W');
+    } else {
+        std::printf("%-12s: (no fix)\r\n", "Position");
+    }
+
+    if (status.zda_time_ms >= 0) {
+        std::printf("UTC (ZDA)    : %04d-%02d-%02d ", (int)status.zda_year,
+                    (int)status.zda_month, (int)status.zda_day);
+        print_time_of_day(status.zda_time_ms);
+    } else {
+        std::printf("UTC (ZDA)    : (waiting)\r\n");
+    }
+
+    if (status.rmc_time_ms >= 0) {
+        std::printf("UTC (RMC)    : ");
+        print_time_of_day(status.rmc_time_ms);
+    } else {
+        std::printf("UTC (RMC)    : (waiting)\r\n");
+    }
+    std::printf("NMEA         : %lu ok, %lu rejected (checksum/format)\r\n",
+                (unsigned long)status.nmea_ok, (unsigned long)status.nmea_rejected);
+    draw_uart_line();
 }
 
 static void draw_sys_block()
 {
-    const float raw = read_temp_c();
-    const float smooth = temp_ema_update_throttled(raw);
+    // Sampled and smoothed by the GPS task, which owns the ADC
+    int32_t temp_mc = 0;
+    const bool have_temp = temp_get_mc(&temp_mc);
 
     char up[32]{};
     uptime_format(up, sizeof(up));
 
     std::printf("\r\n");
 
-    const int32_t temp_c_centi = to_fixed(smooth, 100);
-    print_fixed_2("CPU Temp", temp_c_centi, "C");
+    if (have_temp) {
+        print_fixed_2("CPU Temp", temp_mc / 10, "C");
+    } else {
+        std::printf("%-12s: (waiting)\r\n", "CPU Temp");
+    }
 
     std::printf("%-12s: %s\r\n", "UPTIME", up);
+
+    const uint32_t l0 = core_load_permille(0);
+#if NTP_MULTICORE
+    const uint32_t l1 = core_load_permille(1);
+    std::printf("%-12s: core0 %lu.%lu %% (net/UI), core1 %lu.%lu %% (GPS/PPS)\r\n", "CPU Load",
+                (unsigned long)(l0 / 10), (unsigned long)(l0 % 10),
+                (unsigned long)(l1 / 10), (unsigned long)(l1 % 10));
+#else
+    std::printf("%-12s: core0 %lu.%lu %%\r\n", "CPU Load",
+                (unsigned long)(l0 / 10), (unsigned long)(l0 % 10));
+#endif
 }
 
 static void draw_net_block()
@@ -181,6 +427,30 @@ static void draw_net_block()
 
     if (n_status) {
         std::printf("NTP Port     : %s%d%s\r\n", ANSI_CYN, 123, ANSI_CLR);
+
+        NtpServerStats st{};
+        ntp_server_get_stats(&st);
+        std::printf("NTP Requests : %lu rx / %lu tx (in-place %lu, copied %lu, pbuf allocs %lu)\r\n",
+                    (unsigned long)st.rx, (unsigned long)st.tx,
+                    (unsigned long)st.in_place, (unsigned long)st.copied,
+                    (unsigned long)st.pbuf_allocs);
+        std::printf("NTP FastPath : %lu replies, %lu passed to udp_recv, %lu pkt/s\r\n",
+                    (unsigned long)st.fast_path, (unsigned long)st.fast_fallback,
+                    (unsigned long)rate_update(&g_ntp_tx_rate, st.tx));
+        std::printf("NTP Interlvd : %lu replies\r\n", (unsigned long)st.interleaved);
+        std::printf("NTP RateLim  : %lu limited, %lu KoD RATE sent\r\n",
+                    (unsigned long)st.rate_limited, (unsigned long)st.kod_sent);
+        std::printf("NTP RX->Hdlr : p99 <= %lu us, max %lu us (unstamped %lu)\r\n",
+                    (unsigned long)hist_percentile_us(&st.rx_to_handler, 99),
+                    (unsigned long)st.rx_to_handler.max_us,
+                    (unsigned long)st.rx_unstamped);
+        std::printf("NTP T2->T3   : p99 <= %lu us, max %lu us\r\n",
+                    (unsigned long)hist_percentile_us(&st.turnaround, 99),
+                    (unsigned long)st.turnaround.max_us);
+        std::printf("NTP RX->Sent : p50 <= %lu us, p99 <= %lu us, max %lu us\r\n",
+                    (unsigned long)hist_percentile_us(&st.residence, 50),
+                    (unsigned long)hist_percentile_us(&st.residence, 99),
+                    (unsigned long)st.residence.max_us);
     }
 }
 
@@ -208,9 +478,37 @@ void dashboard_draw()
     draw_header();
     draw_gps_block();
     draw_pps_block();
+    draw_timebase_block();
+    draw_stability_block();
     draw_sys_block();
     draw_net_block();
     draw_notes();
 
     std::fflush(stdout);
 }
+
+void dashboard_dump_stability()
+{
+    StabilityReport r{};
+    stability_get(&r);
+
+    char adev[16], mdev[16] = "", tdev[16] = "";
+    std::printf("%s%s", ANSI_HOME, ANSI_CLEAR);
+    std::printf("# stability: %lu samples, %lu s contiguous, %lu gaps\r\n",
+                (unsigned long)r.samples, (unsigned long)r.run_s, (unsigned long)r.gaps);
+    std::printf("tau_s,n_adev,adev,n_mdev,mdev,tdev_ns\r\n");
+    for (const StabilityPoint& p : r.pt) {
+        if (!p.n_adev) continue;
+        fmt_sci(adev, sizeof adev, p.adev);
+        if (p.n_mdev) {
+            const int32_t deci = to_fixed(p.tdev_ns, 10);
+            fmt_sci(mdev, sizeof mdev, p.mdev);
+            std::snprintf(tdev, sizeof tdev, "%ld.%01ld", (long)(deci / 10), (long)(deci % 10));
+        }
+        std::printf("%lu,%lu,%s,%lu,%s,%s\r\n",
+                    (unsigned long)p.tau_s, (unsigned long)p.n_adev, adev,
+                    (unsigned long)p.n_mdev, mdev, tdev);
+    }
+    std::printf("# end\r\n");
+    std::fflush(stdout);
+}
@@ -13,3 +13,6 @@
 #pragma once
 
 void dashboard_draw();
+
+// Print the stability estimates (stability.h) as CSV, for plotting.
+void dashboard_dump_stability();